@@ -1,18 +1,71 @@
 // Assignment 3 - Page Replacement Algorithms
 // Nathaniel Appiah, Pradhyuman Nandal
+// Build: gcc -O2 -pthread a3.c -o a3 -lm
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
 
 // Structure to represent a page with its page number and dirty bit
+// Page numbers are dense ids 0..universe-1 assigned at load time
 typedef struct 
 {
     int page;
     int dirty;
 } Page;
 
+// Write-back pipeline parameters (--flush-queue and friends)
+typedef struct
+{
+    int queue;     // Flush queue capacity in pages
+    int batch;     // Pages written per batched I/O
+    int interval;  // References between flusher wake-ups
+    int cleaner;   // Dirty resident pages the cleaner queues per wake-up (0 = off)
+} FlushConfig;
+
+// One row of a results table: a configuration and its counts
+typedef struct
+{
+    int frames;  // Number of frames
+    int n;       // Reference register bits (CLK, ESC)
+    int m;       // References between register shifts (CLK, ESC)
+    int page_faults;
+    int write_backs;
+    double seconds;  // Share of its job's run time (job time / rows in the job)
+    double wb_budget;  // Fraction of evictions that may pick a dirty page (ESC only)
+    const FlushConfig *flush;  // Write-back pipeline to model, NULL for none
+    int flush_ios;      // Batched writes the pipeline issued
+    int flush_stalls;   // Dirty evictions that found the flush queue full
+    int pages_written;  // Pages the pipeline wrote (evictions and cleaner)
+    int tau;              // Working-set window in references (WS, WSClock)
+    double avg_resident;  // Mean resident-set size over the trace (WS, WSClock)
+} SimRow;
+
+// Trace page number -> dense id map used while loading
+// Open-addressing hash table with linear probing, grown at half load
+typedef struct
+{
+    int slots;         // Number of table slots (power of two)
+    int shift;         // 64 - log2(slots)
+    long long *keys;   // Trace page number stored in each slot
+    int *vals;         // Dense id stored in each slot, -1 when empty
+} PageIdMap;
+
 // Queue structure for FIFO algorithm
 typedef struct {
     int capacity;
@@ -20,6 +73,8 @@ typedef struct {
     int front;
     int rear;
     Page *arr;  // Array that stores data [pageNumber, dirtyBit] in the Queue
+    int *slot_pages;  // Page number in each slot of arr, -1 when empty (probed)
+    int *slot_of;     // Page -> slot in arr, -1 when not queued (NULL if probed)
 } Queue;
 
 // Frame list structure for OPT algorithm
@@ -28,7 +83,11 @@ typedef struct
     int capacity;
     int size;
     Page *frame;
-    int *order;  // FIFO tie-breaking order
+    int *order;     // FIFO tie-breaking order
+    int *next;      // Next use of the page in each frame
+    int *heap;      // Max-heap of frame slots keyed on (next, oldest order)
+    int *heap_pos;  // Position of each frame slot in the heap
+    int *slot_of;   // Page -> frame slot, -1 when not resident
 } FrameList;
 
 // Clock page structure with reference bits for Second Chance algorithm
@@ -36,6 +95,8 @@ typedef struct {
     int page;
     int dirty;
     unsigned int ref_bits;  // n-bit reference register
+    int epoch;              // Shift epoch ref_bits was last brought up to date
+    int last_use;           // Reference index of the page's last use (WS, WSClock)
 } ClockPage;
 
 // Clock frame list structure for Second Chance algorithm
@@ -43,599 +104,6810 @@ typedef struct {
     int capacity;
     int size;
     int hand;  // Clock hand position
+    int epoch; // Number of periodic register shifts so far
     ClockPage *frame;
+    int *frame_pages;  // Page in each frame, -1 when empty (probed)
+    int *frame_of;  // Page -> frame index (-1 when not resident) at frame_of[page * stride], NULL if probed
+    int stride;     // Spacing of frame_of entries; > 1 when lists share one index
 } ClockFrameList;
 
-Page pages[16000];
-int page_count = 0;
-
-//  FIFO Algorithm Functions 
-
-// Create a queue with given capacity
-static Queue *create_queue(int capacity)
+// A loaded trace: its references and everything derived from them
+typedef struct
 {
-    Queue *q = malloc(sizeof(*q));  // Allocate memory for the queue structure
-    if (!q) return NULL;
+    Page *pages;
+    int count;
+    int capacity;  // Allocated length of pages[]
 
-    q->arr = malloc(sizeof(Page) * capacity);  // Allocate memory for the array
-    if (!q->arr) 
-    { 
-        free(q); 
-        return NULL;
-    }
+    // Distinct pages in the trace; pages[i].page indexes page_numbers[]
+    int universe;
+    long long *page_numbers;  // Dense id -> page number in the trace file
+    PageIdMap ids;            // Page number -> dense id (only while loading)
 
-    q->capacity = capacity;
-    q->size = 0;
-    q->front = 0;
-    q->rear = capacity - 1;
-    return q; 
-}
+    // OPT helper: next_use[i] is the index of the next reference to
+    // pages[i].page after position i, or INT_MAX if the page is never used
+    // again (NULL until build_next_use())
+    int *next_use;
+} Trace;
 
-// Free queue memory
-static void free_queue(Queue *q) 
+//  Trace Loading Functions 
+
+// Home slot of a trace page number (Fibonacci hashing on the top bits)
+static int page_id_hash(const PageIdMap *map, long long pageNum)
 {
-    if (!q) return;
-    free(q->arr);
-    free(q);
+    return (int)(((unsigned long long)pageNum * 0x9E3779B97F4A7C15ULL) >> map->shift);
 }
 
-// Check if queue is full
-static int is_full(const Queue *q) 
+// Resize the id map to `slots` slots, re-inserting every entry
+// Returns 0 on success, -1 on allocation failure
+static int resize_page_ids(PageIdMap *map, int slots, int shift)
 {
-    return (q != NULL && q->size == q->capacity);
+    long long *keys = malloc(sizeof(long long) * slots);
+    int *vals = malloc(sizeof(int) * slots);
+    if (!keys || !vals)
+    {
+        free(keys);
+        free(vals);
+        return -1;
+    }
+    for (int i = 0; i < slots; i++)
+        vals[i] = -1;
+
+    PageIdMap grown = { slots, shift, keys, vals };
+    for (int i = 0; i < map->slots; i++)
+    {
+        if (map->vals[i] == -1)
+            continue;
+        int j = page_id_hash(&grown, map->keys[i]);
+        while (vals[j] != -1)
+            j = (j + 1) & (slots - 1);
+        keys[j] = map->keys[i];
+        vals[j] = map->vals[i];
+    }
+
+    free(map->keys);
+    free(map->vals);
+    *map = grown;
+    return 0;
 }
 
-// Check if queue is empty
-static int is_empty(const Queue *q) 
+// Dense id of a trace page number, assigning the next id to new pages
+// Returns -1 on allocation failure
+static int dense_page_id(Trace *trace, long long pageNum)
 {
-    return (q == NULL || q->size == 0);
+    PageIdMap *map = &trace->ids;
+
+    if (2 * (trace->universe + 1) > map->slots)
+    {
+        if (map->slots >= (1 << 30))
+            return -1;
+        if (resize_page_ids(map, map->slots ? map->slots * 2 : 1024,
+                            map->slots ? map->shift - 1 : 54) != 0)
+            return -1;
+
+        long long *grown = realloc(trace->page_numbers, sizeof(long long) * (map->slots / 2));
+        if (!grown) return -1;
+        trace->page_numbers = grown;
+    }
+
+    int i = page_id_hash(map, pageNum);
+    while (map->vals[i] != -1)
+    {
+        if (map->keys[i] == pageNum)
+            return map->vals[i];
+        i = (i + 1) & (map->slots - 1);
+    }
+
+    map->keys[i] = pageNum;
+    map->vals[i] = trace->universe;
+    trace->page_numbers[trace->universe] = pageNum;
+    return trace->universe++;
 }
 
-// Add element to queue
-static int enqueue(Queue *q, Page value) 
+// Make room for at least `capacity` references in pages[]
+// Returns 0 on success, -1 on allocation failure
+static int reserve_pages(Trace *trace, int capacity)
 {
-    if (q == NULL || is_full(q))
-        return -1;
+    if (capacity <= trace->capacity)
+        return 0;
 
-    q->rear = (q->rear + 1) % q->capacity;
-    q->arr[q->rear] = value;
-    q->size++;
+    Page *grown = realloc(trace->pages, sizeof(Page) * capacity);
+    if (!grown) return -1;
+    trace->pages = grown;
+    trace->capacity = capacity;
     return 0;
 }
 
-// Remove element from queue
-static int dequeue(Queue *q, Page *out) 
+// Append one reference to pages[], growing the array as needed
+// Returns 0 on success, -1 on allocation failure or overflow
+static int append_page(Trace *trace, long long pageNumber, int dirtyBit)
 {
-    if (q == NULL || is_empty(q))
-        return -1;
-        
-    Page val = q->arr[q->front];
-    q->front = (q->front + 1) % q->capacity;
-    q->size--;
+    if (trace->count == trace->capacity)
+    {
+        if (trace->capacity >= INT_MAX / 2)
+            return -1;
+        if (reserve_pages(trace, trace->capacity ? trace->capacity * 2 : 4096) != 0)
+            return -1;
+    }
 
-    if (out) *out = val;
-    return 1;
+    int id = dense_page_id(trace, pageNumber);
+    if (id < 0) return -1;
+
+    trace->pages[trace->count].page = id;
+    trace->pages[trace->count].dirty = dirtyBit;
+    trace->count++;
+    return 0;
 }
 
-// Check if page exists in queue
-static int contains(const Queue *q, int pageNum) 
+// Parse an optionally signed decimal integer starting at *pos
+// Values saturate at the long long range
+// Returns 1 and advances *pos past it, or 0 if there are no digits
+static int scan_int(const char **pos, const char *end, long long *value)
 {
-    if (q == NULL || is_empty(q))
+    const char *c = *pos;
+    int negative = 0;
+
+    if (c < end && (*c == '-' || *c == '+'))
+    {
+        negative = (*c == '-');
+        c++;
+    }
+    if (c == end || *c < '0' || *c > '9')
         return 0;
-        
-    for (int i = 0; i < q->size; i++) {
-        int idx = (q->front + i) % q->capacity;
-        if (q->arr[idx].page == pageNum)
-            return 1;
+
+    unsigned long long v = 0;
+    while (c < end && *c >= '0' && *c <= '9')
+    {
+        if (v <= (unsigned long long)LLONG_MAX)
+            v = v * 10 + (unsigned long long)(*c - '0');
+        c++;
     }
-    return 0;
+    if (v > (unsigned long long)LLONG_MAX)
+        v = (unsigned long long)LLONG_MAX;
+
+    *value = negative ? -(long long)v : (long long)v;
+    *pos = c;
+    return 1;
 }
 
-// Mark a page as dirty in the queue
-static void set_page_dirty(Queue *q, int pageNum)
+// Parse every complete "page,dirty" line in buf[0..len)
+// Lines that do not start with two comma-separated integers are skipped,
+// as sscanf("%d,%d") would. A trailing partial line is parsed only when
+// final is set. Returns the number of bytes consumed, or -1 on failure.
+static long parse_trace_lines(Trace *trace, const char *buf, size_t len, int final)
 {
-    if (!q || is_empty(q))
-        return;
+    const char *c = buf;
+    const char *end = buf + len;
 
-    for (int i = 0; i < q->size; i++) {
-        int idx = (q->front + i) % q->capacity;
-        if (q->arr[idx].page == pageNum) {
-            q->arr[idx].dirty = 1;
-            break;
+    while (c < end)
+    {
+        const char *eol = memchr(c, '\n', end - c);
+        if (!eol)
+        {
+            if (!final)
+                break;
+            eol = end;
+        }
+
+        long long pageNumber, dirtyBit;
+        const char *p = c;
+        while (p < eol && (*p == ' ' || *p == '\t'))
+            p++;
+        if (scan_int(&p, eol, &pageNumber) && p < eol && *p == ',')
+        {
+            p++;
+            while (p < eol && (*p == ' ' || *p == '\t'))
+                p++;
+            if (scan_int(&p, eol, &dirtyBit) && append_page(trace, pageNumber, (int)dirtyBit) != 0)
+                return -1;
         }
+
+        c = (eol < end) ? eol + 1 : end;
     }
+    return (long)(c - buf);
 }
 
-//  OPT Algorithm Functions 
+// Binary trace format: TRACE_MAGIC, the record count as a little-endian
+// 64-bit integer, then one LEB128 varint per reference holding
+// (zigzag(page - previous page) << 1) | dirty. Sequential and clustered
+// traces need one or two bytes per reference and decode without parsing.
+#define TRACE_MAGIC "PGTRACE1"
+#define TRACE_HEADER_SIZE 16
 
-// Create a frame list with given capacity
-static FrameList *create_frameList(int capacity)
+// Decode every complete binary record in buf[0..len)
+// *prev carries the previous page number between calls.
+// Returns the number of bytes consumed, or -1 on a malformed record or
+// allocation failure.
+static long decode_binary_records(Trace *trace, const unsigned char *buf, size_t len, long long *prev)
 {
-    FrameList *fl = malloc(sizeof(*fl));
-    if (!fl) return NULL;
+    size_t i = 0;
 
-    fl->frame = malloc(sizeof(Page) * capacity);
-    fl->order = malloc(sizeof(int) * capacity);
-    
-    if (!fl->frame || !fl->order)
+    while (i < len)
     {
-        free(fl->frame);
-        free(fl->order);
-        free(fl);
-        return NULL;
-    }
+        unsigned long long value = 0;
+        int shift = 0;
+        size_t j = i;
 
-    fl->capacity = capacity;
-    fl->size = 0;
+        while (j < len && (buf[j] & 0x80))
+        {
+            if (shift > 63)
+                return -1;
+            value |= (unsigned long long)(buf[j] & 0x7F) << shift;
+            shift += 7;
+            j++;
+        }
+        if (j == len)
+            break;  // Record continues in the next block
+        value |= (unsigned long long)buf[j] << shift;
 
-    return fl;
+        unsigned long long zz = value >> 1;
+        long long delta = (long long)(zz >> 1) ^ -(long long)(zz & 1);
+        long long page = (long long)((unsigned long long)*prev + (unsigned long long)delta);
+        if (append_page(trace, page, (int)(value & 1)) != 0)
+            return -1;
+
+        *prev = page;
+        i = j + 1;
+    }
+    return (long)i;
 }
 
-// Free frame list memory
-static void free_frameList(FrameList *fl)
+// Record count stored in a binary trace header
+static long long binary_record_count(const unsigned char *header)
 {
-    if (!fl) return;
-    free(fl->frame);
-    free(fl->order);
-    free(fl);
+    unsigned long long count = 0;
+    for (int b = 7; b >= 0; b--)
+        count = (count << 8) | header[8 + b];
+    return (long long)count;
 }
 
-// Helper function for OPT: find next use of a page in the future
-// Returns INT_MAX if page is never used again
-static int find_next_use(int curr_index, int page)
+// Size of each read when the trace is streamed rather than mapped
+#define TRACE_BLOCK_SIZE (1 << 20)
+
+// Read a trace from fd: CSV (header line, then "page,dirty" lines) or the
+// binary format above, recognised by its magic number
+// Regular files are memory-mapped and decoded in place; pipes are read in
+// large blocks. pages[] grows to fit the whole trace.
+// Returns 0 on success, -1 on failure
+static int read_trace(Trace *trace, int fd)
 {
-    for (int i = curr_index + 1; i < page_count; i++)
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
     {
-        if (pages[i].page == page)
-            return i;
-    }
-    return INT_MAX;  // Page not used again
-}
+        size_t len = (size_t)st.st_size;
+        char *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            madvise(map, len, MADV_SEQUENTIAL);
+            long used = 0;
 
-// Clock Algorithm Functions
+            if (len >= TRACE_HEADER_SIZE && memcmp(map, TRACE_MAGIC, 8) == 0)
+            {
+                // Binary trace: the header says how much to reserve, but
+                // every record takes at least one byte of the file
+                long long count = binary_record_count((const unsigned char *)map);
+                long long reserve = count;
+                long long prev = 0;
+                if ((unsigned long long)reserve > len - TRACE_HEADER_SIZE)
+                    reserve = (long long)(len - TRACE_HEADER_SIZE);
+                if (count < 0 || count > INT_MAX || reserve_pages(trace, (int)reserve) != 0)
+                    used = -1;
+                else
+                    used = decode_binary_records(trace, (const unsigned char *)map + TRACE_HEADER_SIZE,
+                                                 len - TRACE_HEADER_SIZE, &prev);
 
-// Create a clock frame list with given capacity
+                // A cut-off record or a count other than the header's is malformed
+                if (used >= 0 && ((size_t)used != len - TRACE_HEADER_SIZE || trace->count != count))
+                    used = -1;
+            }
+            else
+            {
+                // Pre-size for ~8-byte lines so typical traces grow at most once
+                size_t estimate = len / 8;
+                if (estimate > INT_MAX / 2)
+                    estimate = INT_MAX / 2;
 
-static ClockFrameList *create_clock_frameList(int capacity)
-{
-    ClockFrameList *cfl = malloc(sizeof(*cfl));
-    if (!cfl) return NULL;
+                // Skip header
+                const char *body = memchr(map, '\n', len);
+                if (reserve_pages(trace, (int)estimate + 1) != 0)
+                    used = -1;
+                else if (body)
+                    used = parse_trace_lines(trace, body + 1, len - (size_t)(body + 1 - map), 1);
+            }
 
-    cfl->frame = malloc(sizeof(ClockPage) * capacity);
-    if (!cfl->frame)
-    {
-        free(cfl);
-        return NULL;
+            munmap(map, len);
+            return (used < 0) ? -1 : 0;
+        }
     }
 
-    cfl->capacity = capacity;
-    cfl->size = 0;
-    cfl->hand = 0;
-    
-    // Initialize all frames
-    for (int i = 0; i < capacity; i++)
+    char *buf = malloc(TRACE_BLOCK_SIZE);
+    if (!buf) return -1;
+
+    size_t held = 0;       // Unparsed bytes at the start of buf
+    int in_header = 1;
+    int skipping = 0;      // Discarding the rest of an overlong line
+    int binary = 0;
+    long long prev = 0;    // Previous page of a binary trace
+    long long expected = 0;  // Record count in the binary header
+    while (1)
     {
-        cfl->frame[i].page = -1;
-        cfl->frame[i].dirty = 0;
-        cfl->frame[i].ref_bits = 0;
-    }
-    
-    return cfl;
-}
+        ssize_t got = read(fd, buf + held, TRACE_BLOCK_SIZE - held);
+        if (got < 0)
+        {
+            free(buf);
+            return -1;
+        }
+        held += (size_t)got;
 
-// Free clock frame list memory
-static void free_clock_frameList(ClockFrameList *cfl)
-{
-    if (!cfl) return;
-    free(cfl->frame);
-    free(cfl);
-}
+        if (skipping)
+        {
+            // Nothing is parsed until the overlong line ends
+            char *eol = memchr(buf, '\n', held);
+            if (!eol)
+            {
+                held = 0;
+                if (got == 0)
+                    break;
+                continue;
+            }
+            held -= (size_t)(eol + 1 - buf);
+            memmove(buf, eol + 1, held);
+            skipping = 0;
+        }
 
-// Check if page exists in clock frames and return its index
-static int contains_clock_frame(ClockFrameList *cfl, int pageNum, int *index)
-{
-    for (int i = 0; i < cfl->size; i++)
-    {
-        if (cfl->frame[i].page == pageNum)
+        size_t start = 0;
+        if (in_header)
         {
-            if (index) *index = i;
-            return 1;
+            // Wait for enough bytes to tell the formats apart
+            if (held < TRACE_HEADER_SIZE && got > 0)
+                continue;
+
+            if (held >= TRACE_HEADER_SIZE && memcmp(buf, TRACE_MAGIC, 8) == 0)
+            {
+                binary = 1;
+                expected = binary_record_count((const unsigned char *)buf);
+                start = TRACE_HEADER_SIZE;
+            }
+            else
+            {
+                // Skip header
+                char *eol = memchr(buf, '\n', held);
+                if (!eol && got > 0 && held < TRACE_BLOCK_SIZE)
+                    continue;
+                start = eol ? (size_t)(eol + 1 - buf) : held;
+                skipping = !eol && got > 0;  // Header line longer than a block
+            }
+            in_header = 0;
+        }
+
+        long used;
+        if (binary)
+            used = decode_binary_records(trace, (const unsigned char *)buf + start, held - start, &prev);
+        else
+            used = parse_trace_lines(trace, buf + start, held - start, got == 0);
+        if (used < 0)
+        {
+            free(buf);
+            return -1;
+        }
+
+        held -= start + (size_t)used;
+        memmove(buf, buf + start + used, held);
+        if (got == 0)
+        {
+            // A binary trace must end on a record boundary with the header's count
+            if (binary && (held > 0 || trace->count != expected))
+            {
+                free(buf);
+                return -1;
+            }
+            break;
+        }
+        if (held == TRACE_BLOCK_SIZE)
+        {
+            // Drop an overlong line, including what is still to be read
+            held = 0;
+            skipping = 1;
         }
     }
+
+    free(buf);
     return 0;
 }
 
-// Shift all reference registers right by 1 bit
-static void shift_reference_bits(ClockFrameList *cfl, int n)
+// Load a trace from fd and remap its page numbers to dense ids
+// Every engine indexes flat arrays of universe entries by page id
+// Returns 0 on success, -1 on failure
+static int load_trace(Trace *trace, int fd)
 {
-    for (int i = 0; i < cfl->size; i++)
-    {
-        cfl->frame[i].ref_bits >>= 1;
-    }
+    int result = read_trace(trace, fd);
+
+    free(trace->ids.keys);
+    free(trace->ids.vals);
+    trace->ids.keys = NULL;
+    trace->ids.vals = NULL;
+    trace->ids.slots = 0;
+    return result;
 }
 
-// Set the leftmost  bit of the reference register to 1
-static void set_reference_bit(ClockFrameList *cfl, int index, int n)
+// Streaming trace writer: CSV (as read by main) or the binary format,
+// encoded into one block buffer and written a block at a time
+typedef struct
 {
-    unsigned int mask = 1U << (n - 1); 
-    cfl->frame[index].ref_bits |= mask;  // Using bitmask with OR to set the bit
-}
+    FILE *out;
+    int binary;
+    unsigned char *buf;
+    size_t used;       // Bytes held in buf
+    long long prev;    // Previous page of a binary trace
+    int failed;        // Set once a write fails
+} TraceWriter;
 
-// Find victim page using Second Chance algorithm
-// Returns the index of the page to be replaced
-static int find_victim_clock(ClockFrameList *cfl, int n)
+// Start a trace of `count` references on out (binary traces record the
+// count in their header, so it must be exact)
+// Returns 0 on success, -1 on a write or allocation failure
+static int open_trace_writer(TraceWriter *w, FILE *out, int binary, long long count)
 {
-    // Create mask for n bits (all 1s for n bits)
-    unsigned int n_bit_mask = (1U << n) - 1;
-    int start_hand = cfl->hand;  // Hand points towards a frame currently being examined
-    
-    while (1)
+    w->out = out;
+    w->binary = binary;
+    w->used = 0;
+    w->prev = 0;
+    w->failed = 0;
+    w->buf = malloc(TRACE_BLOCK_SIZE);
+    if (!w->buf) return -1;
+
+    if (binary)
     {
-        // Check if all reference bits are 0
-        if ((cfl->frame[cfl->hand].ref_bits & n_bit_mask) == 0)
-        {
-            // Found victim with all 0s
-            int victim = cfl->hand;
-            cfl->hand = (cfl->hand + 1) % cfl->size;
-            return victim;
-        }
-        
-        // Give second chance: shift right by 1
-        cfl->frame[cfl->hand].ref_bits >>= 1;
-        cfl->hand = (cfl->hand + 1) % cfl->size;
-        
-        // Prevent infinite loop (safety check)
-        if (cfl->hand == start_hand)
-        {
-            // If we've gone full circle, just pick current position
-            int victim = cfl->hand;
-            cfl->hand = (cfl->hand + 1) % cfl->size;
-            return victim;
-        }
+        memcpy(w->buf, TRACE_MAGIC, 8);
+        for (int b = 0; b < 8; b++)
+            w->buf[8 + b] = (unsigned char)((unsigned long long)count >> (8 * b));
+        w->used = TRACE_HEADER_SIZE;
+    }
+    else
+    {
+        memcpy(w->buf, "Page#,dirty?\n", 13);
+        w->used = 13;
     }
+    return 0;
 }
 
-int main(int argc, char *argv[])
+// Append one reference
+static void write_trace_record(TraceWriter *w, long long page, int dirty)
 {
-    // Check if the user provided the correct number of arguments
-    if (argc < 2)
+    // Flush before a record could overrun the buffer (22 bytes max)
+    if (w->used > TRACE_BLOCK_SIZE - 24)
     {
-        fprintf(stderr, "Usage: %s FIFO|OPT|CLK < inputfile.csv\n", argv[0]);
-        return 1;
+        if (fwrite(w->buf, 1, w->used, w->out) != w->used)
+            w->failed = 1;
+        w->used = 0;
     }
 
-    // Read input from stdin
-    char line[256];
-    fgets(line, sizeof(line), stdin);  // Skip header
+    unsigned char *p = w->buf + w->used;
+    if (w->binary)
+    {
+        long long delta = (long long)((unsigned long long)page - (unsigned long long)w->prev);
+        unsigned long long zz = ((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63);
+        unsigned long long value = (zz << 1) | (dirty == 1);
+        w->prev = page;
 
-    // Read all pages into global array
-    while (fgets(line, sizeof(line), stdin)) {
-        int pageNumber, dirtyBit;
-        if (sscanf(line, "%d,%d", &pageNumber, &dirtyBit) == 2) {
-            pages[page_count].page = pageNumber;
-            pages[page_count].dirty = dirtyBit;
-            page_count++;
+        while (value >= 0x80)
+        {
+            *p++ = (unsigned char)(value | 0x80);
+            value >>= 7;
         }
+        *p++ = (unsigned char)value;
     }
-
-    //  FIFO ALGORITHM 
-    if (strcmp(argv[1], "FIFO") == 0)
+    else
     {
-        printf("FIFO\n");
-        printf("+--------+--------------+--------------+\n");
-        printf("| Frames | Page Faults  | Write-backs  |\n");
-        printf("+--------+--------------+--------------+\n");
-
-        // Run simulation for 1 to 100 frames
-        for (int f = 1; f <= 100; f++) 
+        // Digits are produced backwards, then copied in order
+        char digits[20];
+        int len = 0;
+        unsigned long long v = (page < 0) ? -(unsigned long long)page : (unsigned long long)page;
+        do
         {
-            Queue *frames = create_queue(f);
-            int page_faults = 0;
-            int write_backs = 0;
+            digits[len++] = (char)('0' + v % 10);
+            v /= 10;
+        } while (v);
 
-            // Process each page reference
-            for (int j = 0; j < page_count; j++) 
-            {
-                Page current = pages[j];
+        if (page < 0)
+            *p++ = '-';
+        while (len > 0)
+            *p++ = (unsigned char)digits[--len];
+        *p++ = ',';
+        *p++ = (unsigned char)('0' + (dirty == 1));
+        *p++ = '\n';
+    }
+    w->used = (size_t)(p - w->buf);
+}
 
-                // Check if page is not in memory
-                if (!contains(frames, current.page)) 
-                { 
-                    page_faults++;
+// Flush the writer and release its buffer
+// Returns 0 if every record was written, -1 otherwise
+static int close_trace_writer(TraceWriter *w)
+{
+    if (w->used > 0 && fwrite(w->buf, 1, w->used, w->out) != w->used)
+        w->failed = 1;
+    free(w->buf);
+    w->buf = NULL;
+    return w->failed ? -1 : 0;
+}
 
-                    // If frames are full, evict the oldest page (FIFO)
-                    if (is_full(frames)) 
-                    {
-                        Page evicted;
-                        dequeue(frames, &evicted);
-                        if (evicted.dirty == 1)
-                            write_backs++;
-                    }
+// Write pages[] to out in the binary trace format
+// Returns 0 on success, -1 on a write or allocation failure
+static int save_binary_trace(const Trace *trace, FILE *out)
+{
+    TraceWriter w;
+    if (open_trace_writer(&w, out, 1, trace->count) != 0)
+        return -1;
 
-                    // Add new page to frames
-                    enqueue(frames, current);
-                } 
-                else if (current.dirty == 1) 
-                {
-                    // Page hit - mark as dirty if current reference is dirty
-                    set_page_dirty(frames, current.page);
-                }
-            }
-            printf("| %6d | %12d | %12d |\n", f, page_faults, write_backs);
-            free_queue(frames);
-        }
-        printf("+--------+--------------+--------------+\n");
-    }
+    for (int i = 0; i < trace->count; i++)
+        write_trace_record(&w, trace->page_numbers[trace->pages[i].page], trace->pages[i].dirty);
+    return close_trace_writer(&w);
+}
+
+// Allocate a page-indexed array with every entry set to -1
+static int *create_page_array(const Trace *trace)
+{
+    int *arr = malloc(sizeof(int) * (trace->universe > 0 ? trace->universe : 1));
+    if (!arr) return NULL;
+
+    for (int p = 0; p < trace->universe; p++)
+        arr[p] = -1;
+    return arr;
+}
+
+//  Trace Generator 
+
+// Access distributions of generated traces
+enum { DIST_UNIFORM, DIST_ZIPF, DIST_SEQ, DIST_LOOP, DIST_PHASE, DIST_COUNT };
+static const char *const dist_names[DIST_COUNT] = { "uniform", "zipf", "seq", "loop", "phase" };
+
+// Parameters of a generated trace
+typedef struct
+{
+    long long length;        // References to write
+    int universe;            // Pages are 0..universe-1
+    int dist;                // DIST_*
+    double skew;             // Zipf exponent (zipf)
+    int set_size;            // Working set (loop) or hot set (phase) size
+    long long phase_length;  // References before the hot set moves (phase)
+    double hot;              // Fraction of references to the hot set (phase)
+    double dirty;            // Fraction of dirty references
+    unsigned long long seed;
+    int binary;              // Write the binary format instead of CSV
+} GenSpec;
+
+// Next value of a SplitMix64 generator (fast, and fully determined by the seed)
+static unsigned long long next_random(unsigned long long *state)
+{
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform integer in [0, n) by multiply-high (no division)
+static long long random_below(unsigned long long *state, unsigned long long n)
+{
+    return (long long)(((unsigned __int128)next_random(state) * n) >> 64);
+}
+
+// Threshold such that next_random() < threshold with probability p
+static unsigned long long probability_cut(double p)
+{
+    if (p <= 0) return 0;
+    if (p >= 1) return ~0ULL;
+    return (unsigned long long)(p * 18446744073709551616.0);
+}
+
+// Zipf sampler over ranks 1..n with P(k) ~ 1 / k^exponent, using
+// rejection-inversion (Hormann and Derflinger): O(1) per sample and no
+// table, so the universe can be as large as the page id range
+typedef struct
+{
+    long long n;
+    double exponent;
+    double h_x1;   // H(1.5) - 1
+    double h_n;    // H(n + 0.5)
+    double s;      // Acceptance shortcut
+} ZipfSampler;
+
+// log(1 + x) / x, accurate near 0
+static double zipf_helper1(double x)
+{
+    return (fabs(x) > 1e-8) ? log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+// (exp(x) - 1) / x, accurate near 0
+static double zipf_helper2(double x)
+{
+    return (fabs(x) > 1e-8) ? expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+}
+
+// Integral of the (continuous) Zipf density h(x) = x^-exponent
+static double zipf_h_integral(const ZipfSampler *z, double x)
+{
+    double log_x = log(x);
+    return zipf_helper2((1 - z->exponent) * log_x) * log_x;
+}
+
+// h(x) = x^-exponent
+static double zipf_h(const ZipfSampler *z, double x)
+{
+    return exp(-z->exponent * log(x));
+}
+
+// Inverse of zipf_h_integral()
+static double zipf_h_integral_inverse(const ZipfSampler *z, double x)
+{
+    double t = x * (1 - z->exponent);
+    if (t < -1)
+        t = -1;
+    return exp(zipf_helper1(t) * x);
+}
+
+// Prepare a sampler over ranks 1..n (exponent > 0)
+static void init_zipf(ZipfSampler *z, long long n, double exponent)
+{
+    z->n = n;
+    z->exponent = exponent;
+    z->h_x1 = zipf_h_integral(z, 1.5) - 1;
+    z->h_n = zipf_h_integral(z, n + 0.5);
+    z->s = 2 - zipf_h_integral_inverse(z, zipf_h_integral(z, 2.5) - zipf_h(z, 2));
+}
+
+// Draw a rank in 1..n (1 is the most frequent)
+static long long zipf_sample(const ZipfSampler *z, unsigned long long *state)
+{
+    while (1)
+    {
+        double u = z->h_n + (next_random(state) >> 11) * 0x1.0p-53 * (z->h_x1 - z->h_n);
+        double x = zipf_h_integral_inverse(z, u);
+        long long k = (long long)(x + 0.5);
+        if (k < 1)
+            k = 1;
+        else if (k > z->n)
+            k = z->n;
+
+        if (k - x <= z->s || u >= zipf_h_integral(z, k + 0.5) - zipf_h(z, (double)k))
+            return k;
+    }
+}
+
+// Write the trace described by spec to out, one block at a time
+// Returns 0 on success, -1 on a write or allocation failure
+static int generate_trace(const GenSpec *spec, FILE *out)
+{
+    TraceWriter w;
+    if (open_trace_writer(&w, out, spec->binary, spec->length) != 0)
+        return -1;
+
+    ZipfSampler zipf;
+    if (spec->dist == DIST_ZIPF)
+        init_zipf(&zipf, spec->universe, spec->skew);
+
+    unsigned long long state = spec->seed;
+    unsigned long long dirty_cut = probability_cut(spec->dirty);
+    unsigned long long hot_cut = probability_cut(spec->hot);
+    long long cursor = 0;    // Position in the scan (seq, loop)
+    long long hot_base = 0;  // First page of the hot set (phase)
+    long long phase_left = 0;
+
+    for (long long i = 0; i < spec->length && !w.failed; i++)
+    {
+        long long page;
+
+        if (spec->dist == DIST_UNIFORM)
+            page = random_below(&state, spec->universe);
+        else if (spec->dist == DIST_ZIPF)
+            page = zipf_sample(&zipf, &state) - 1;
+        else if (spec->dist == DIST_SEQ || spec->dist == DIST_LOOP)
+        {
+            // seq scans the whole universe, loop a working set at its start
+            page = cursor;
+            if (++cursor == (spec->dist == DIST_SEQ ? spec->universe : spec->set_size))
+                cursor = 0;
+        }
+        else
+        {
+            // A hot set that moves to a random place every phase_length references
+            if (phase_left-- == 0)
+            {
+                hot_base = random_below(&state, spec->universe);
+                phase_left = spec->phase_length - 1;
+            }
+            if (next_random(&state) < hot_cut)
+            {
+                page = hot_base + random_below(&state, spec->set_size);
+                if (page >= spec->universe)
+                    page -= spec->universe;
+            }
+            else
+                page = random_below(&state, spec->universe);
+        }
+
+        int dirty = (spec->dirty >= 1 || next_random(&state) < dirty_cut);
+        write_trace_record(&w, page, dirty);
+    }
+
+    return close_trace_writer(&w);
+}
+
+//  Frame Probe Functions 
+
+// Frame sets up to this size may be searched with probe_frames() instead
+// of a page-indexed array. A cached index entry is still cheaper than an
+// AVX2 probe (about 1-2 ns against 9 ns for 50 frames), so probing is used
+// when the universe is too large to index: the page numbers stay in a few
+// cache lines and no universe-sized array has to be allocated.
+#define SIMD_PROBE_MAX 64
+
+// Index of key in keys[0..count), or -1 (portable version)
+static int probe_scalar(const int *keys, int count, int key)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (keys[i] == key)
+            return i;
+    }
+    return -1;
+}
+
+#ifdef HAVE_X86_SIMD
+// Index of key in keys[0..count), or -1 (4 page numbers per compare)
+__attribute__((target("sse2")))
+static int probe_sse2(const int *keys, int count, int key)
+{
+    __m128i needle = _mm_set1_epi32(key);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(keys + i));
+        int hits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        if (hits)
+            return i + __builtin_ctz(hits);
+    }
+    for (; i < count; i++)
+    {
+        if (keys[i] == key)
+            return i;
+    }
+    return -1;
+}
+
+// Index of key in keys[0..count), or -1 (16 page numbers per iteration)
+__attribute__((target("avx2")))
+static int probe_avx2(const int *keys, int count, int key)
+{
+    __m256i needle = _mm256_set1_epi32(key);
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i lo = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(keys + i)), needle);
+        __m256i hi = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(keys + i + 8)), needle);
+        int hits = _mm256_movemask_ps(_mm256_castsi256_ps(lo)) |
+                   (_mm256_movemask_ps(_mm256_castsi256_ps(hi)) << 8);
+        if (hits)
+            return i + __builtin_ctz(hits);
+    }
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(keys + i)), needle);
+        int hits = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if (hits)
+            return i + __builtin_ctz(hits);
+    }
+    for (; i < count; i++)
+    {
+        if (keys[i] == key)
+            return i;
+    }
+    return -1;
+}
+#endif
+
+// Frame probe for this CPU, chosen by init_probe()
+static int (*probe_frames)(const int *keys, int count, int key) = probe_scalar;
+
+// Pick the widest frame probe the CPU supports
+static void init_probe(void)
+{
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        probe_frames = probe_avx2;
+    else if (__builtin_cpu_supports("sse2"))
+        probe_frames = probe_sse2;
+#endif
+}
+
+//  Write-back Pipeline Functions 
+
+// Asynchronous write-back model layered on any engine: an evicted dirty
+// page goes to a bounded flush queue instead of being written in place, a
+// flusher that wakes every `interval` references writes the queue in
+// batches, and an optional cleaner queues the oldest dirty resident pages
+// so later evictions of them are free. An eviction that finds the queue
+// full stalls until one batch is written.
+// The engine only reports its evictions; between two of them the pipeline
+// replays the trace itself to follow which resident pages are dirty. The
+// cleaner does not feed back into the engine's dirty bits, so victim choice
+// (and the engine's own counts) are unchanged.
+typedef struct
+{
+    const FlushConfig *config;
+    const Trace *trace;
+    int next_ref;          // First reference not yet replayed
+    int queued;            // Pages waiting in the flush queue
+    unsigned char *dirty;  // Page -> dirtied since loaded or last cleaned
+    int *older;            // Page -> dirty page dirtied just before it, -1 at the end
+    int *newer;            // Page -> dirty page dirtied just after it, -1 at the end
+    int oldest;            // Ends of the dirty list, -1 when empty
+    int newest;
+    int ios;
+    int stalls;
+    int written;
+} FlushPipe;
+
+// Create the pipeline for one configuration (NULL config gives NULL)
+// Returns NULL on allocation failure; check config before treating NULL as off
+static FlushPipe *create_flush_pipe(const Trace *trace, const FlushConfig *config)
+{
+    if (!config) return NULL;
+
+    FlushPipe *pipe = calloc(1, sizeof(FlushPipe));
+    if (!pipe) return NULL;
+    size_t universe = trace->universe > 0 ? trace->universe : 1;
+    pipe->dirty = calloc(universe, 1);
+    pipe->older = malloc(sizeof(int) * universe);
+    pipe->newer = malloc(sizeof(int) * universe);
+    if (!pipe->dirty || !pipe->older || !pipe->newer)
+    {
+        free(pipe->dirty);
+        free(pipe->older);
+        free(pipe->newer);
+        free(pipe);
+        return NULL;
+    }
+    pipe->config = config;
+    pipe->trace = trace;
+    pipe->oldest = -1;
+    pipe->newest = -1;
+    return pipe;
+}
+
+// Free a pipeline (NULL is ignored)
+static void free_flush_pipe(FlushPipe *pipe)
+{
+    if (!pipe) return;
+    free(pipe->dirty);
+    free(pipe->older);
+    free(pipe->newer);
+    free(pipe);
+}
+
+// Take a page off the dirty list and mark it clean
+static void flush_mark_clean(FlushPipe *pipe, int page)
+{
+    int o = pipe->older[page], w = pipe->newer[page];
+    if (o != -1) pipe->newer[o] = w; else pipe->oldest = w;
+    if (w != -1) pipe->older[w] = o; else pipe->newest = o;
+    pipe->dirty[page] = 0;
+}
+
+// Write one batch from the flush queue as a single I/O
+static void flush_issue(FlushPipe *pipe)
+{
+    int batch = pipe->config->batch;
+    pipe->queued -= pipe->queued < batch ? pipe->queued : batch;
+    pipe->ios++;
+}
+
+// Replay references [next_ref, upto): track dirty pages and wake the
+// flusher (and cleaner) every interval references
+static void flush_replay(FlushPipe *pipe, int upto)
+{
+    const FlushConfig *c = pipe->config;
+    for (int i = pipe->next_ref; i < upto; i++)
+    {
+        int pg = pipe->trace->pages[i].page;
+        if (pipe->trace->pages[i].dirty == 1 && !pipe->dirty[pg])
+        {
+            pipe->dirty[pg] = 1;
+            pipe->older[pg] = pipe->newest;
+            pipe->newer[pg] = -1;
+            if (pipe->newest != -1) pipe->newer[pipe->newest] = pg; else pipe->oldest = pg;
+            pipe->newest = pg;
+        }
+
+        if ((i + 1) % c->interval != 0)
+            continue;
+        if (pipe->queued > 0)
+            flush_issue(pipe);
+        for (int k = 0; k < c->cleaner && pipe->oldest != -1 && pipe->queued < c->queue; k++)
+        {
+            flush_mark_clean(pipe, pipe->oldest);
+            pipe->queued++;
+            pipe->written++;
+        }
+    }
+    if (upto > pipe->next_ref)
+        pipe->next_ref = upto;
+}
+
+// Report that the engine evicted `page` (or, for WSClock, wrote it back
+// while it stays resident) while serving reference i
+static void flush_evict(FlushPipe *pipe, int i, int page)
+{
+    flush_replay(pipe, i);
+    if (!pipe->dirty[page])
+        return;
+
+    flush_mark_clean(pipe, page);
+    if (pipe->queued >= pipe->config->queue)
+    {
+        // Queue full - the eviction waits for one batch to be written
+        pipe->stalls++;
+        flush_issue(pipe);
+    }
+    pipe->queued++;
+    pipe->written++;
+}
+
+// Replay the rest of the trace, drain the queue, store the counts in row
+// and free the pipeline (NULL is ignored)
+static void finish_flush_pipe(FlushPipe *pipe, SimRow *row)
+{
+    if (!pipe) return;
+    flush_replay(pipe, pipe->trace->count);
+    while (pipe->queued > 0)
+        flush_issue(pipe);
+    row->flush_ios = pipe->ios;
+    row->flush_stalls = pipe->stalls;
+    row->pages_written = pipe->written;
+    free_flush_pipe(pipe);
+}
+
+// Run a per-configuration engine once for each row, each with its own
+// pipeline when the row models one
+// Returns 0 on success, -1 on allocation failure
+static int run_each_row(const Trace *trace, SimRow *rows, int count,
+                        int (*run)(const Trace *, int, int *, int *, FlushPipe *))
+{
+    for (int r = 0; r < count; r++)
+    {
+        FlushPipe *pipe = create_flush_pipe(trace, rows[r].flush);
+        if (rows[r].flush && !pipe)
+            return -1;
+        if (run(trace, rows[r].frames, &rows[r].page_faults, &rows[r].write_backs, pipe) != 0)
+        {
+            free_flush_pipe(pipe);
+            return -1;
+        }
+        finish_flush_pipe(pipe, &rows[r]);
+    }
+    return 0;
+}
+
+//  FIFO Algorithm Functions 
+
+// Create a queue with given capacity
+static Queue *create_queue(const Trace *trace, int capacity)
+{
+    Queue *q = malloc(sizeof(*q));  // Allocate memory for the queue structure
+    if (!q) return NULL;
+
+    q->arr = malloc(sizeof(Page) * capacity);  // Allocate memory for the array
+    q->slot_pages = malloc(sizeof(int) * capacity);
+
+    // Small queues are probed; larger ones keep a page lookup in sync with arr
+    q->slot_of = (capacity > SIMD_PROBE_MAX) ? create_page_array(trace) : NULL;
+    if (!q->arr || !q->slot_pages || (capacity > SIMD_PROBE_MAX && !q->slot_of)) 
+    { 
+        free(q->arr);
+        free(q->slot_pages);
+        free(q->slot_of);
+        free(q); 
+        return NULL;
+    }
+
+    for (int i = 0; i < capacity; i++)
+        q->slot_pages[i] = -1;
+
+    q->capacity = capacity;
+    q->size = 0;
+    q->front = 0;
+    q->rear = capacity - 1;
+    return q; 
+}
+
+// Free queue memory
+static void free_queue(Queue *q) 
+{
+    if (!q) return;
+    free(q->arr);
+    free(q->slot_pages);
+    free(q->slot_of);
+    free(q);
+}
+
+// Check if queue is full
+static int is_full(const Queue *q) 
+{
+    return (q != NULL && q->size == q->capacity);
+}
+
+// Check if queue is empty
+static int is_empty(const Queue *q) 
+{
+    return (q == NULL || q->size == 0);
+}
+
+// Add element to queue
+static int enqueue(Queue *q, Page value) 
+{
+    if (q == NULL || is_full(q))
+        return -1;
+
+    q->rear = (q->rear + 1) % q->capacity;
+    q->arr[q->rear] = value;
+    q->slot_pages[q->rear] = value.page;
+    if (q->slot_of)
+        q->slot_of[value.page] = q->rear;
+    q->size++;
+    return 0;
+}
+
+// Remove element from queue
+static int dequeue(Queue *q, Page *out) 
+{
+    if (q == NULL || is_empty(q))
+        return -1;
+        
+    Page val = q->arr[q->front];
+    q->slot_pages[q->front] = -1;
+    if (q->slot_of)
+        q->slot_of[val.page] = -1;
+    q->front = (q->front + 1) % q->capacity;
+    q->size--;
+
+    if (out) *out = val;
+    return 1;
+}
+
+// Slot holding a page in the queue, or -1
+static int queue_slot(const Queue *q, int pageNum)
+{
+    if (q->slot_of)
+        return q->slot_of[pageNum];
+    return probe_frames(q->slot_pages, q->capacity, pageNum);
+}
+
+// Check if page exists in queue
+static int contains(const Queue *q, int pageNum) 
+{
+    if (q == NULL || is_empty(q))
+        return 0;
+
+    return queue_slot(q, pageNum) != -1;
+}
+
+// Mark a page as dirty in the queue
+static void set_page_dirty(Queue *q, int pageNum)
+{
+    if (!q || is_empty(q))
+        return;
+
+    int idx = queue_slot(q, pageNum);
+    if (idx != -1)
+        q->arr[idx].dirty = 1;
+}
+
+// Run FIFO with f frames over the whole trace, reporting evictions to
+// pipe (NULL for none)
+// Returns 0 on success, -1 on allocation failure
+static int run_fifo(const Trace *trace, int f, int *page_faults, int *write_backs, FlushPipe *pipe)
+{
+    Queue *frames = create_queue(trace, f);
+    if (!frames) return -1;
+
+    *page_faults = 0;
+    *write_backs = 0;
+
+    // Process each page reference
+    for (int j = 0; j < trace->count; j++) 
+    {
+        Page current = trace->pages[j];
+
+        // Check if page is not in memory
+        if (!contains(frames, current.page)) 
+        { 
+            (*page_faults)++;
+
+            // If frames are full, evict the oldest page (FIFO)
+            if (is_full(frames)) 
+            {
+                Page evicted = { 0, 0 };
+                dequeue(frames, &evicted);
+                if (evicted.dirty == 1)
+                    (*write_backs)++;
+                if (pipe)
+                    flush_evict(pipe, j, evicted.page);
+            }
+
+            // Add new page to frames
+            enqueue(frames, current);
+        } 
+        else if (current.dirty == 1) 
+        {
+            // Page hit - mark as dirty if current reference is dirty
+            set_page_dirty(frames, current.page);
+        }
+    }
+
+    free_queue(frames);
+    return 0;
+}
+
+// Memory budget for the per-page, per-capacity state of run_fifo_sweep()
+#define FIFO_SWEEP_BUDGET (64 << 20)
+
+// Insertion ring length of one capacity: no more than `distinct` pages can
+// ever be resident, so larger frame counts never wrap past that
+static size_t fifo_ring_length(int frames, int distinct)
+{
+    int len = (frames < distinct) ? frames : distinct;
+    return (size_t)(len > 0 ? len : 1);
+}
+
+// Number of rows from rows[0] that one sweep pass can hold within
+// FIFO_SWEEP_BUDGET, counting each capacity's page state and ring;
+// *ring_total gets the length of their rings together
+// Returns 0 when even rows[0] does not fit
+static int fifo_sweep_block(const SimRow *rows, int count, int distinct, size_t *ring_total)
+{
+    size_t per_capacity = (size_t)(distinct > 0 ? distinct : 1) * (sizeof(int) + 1);
+    size_t used = 0;
+    int width = 0;
+
+    *ring_total = 0;
+    while (width < count)
+    {
+        size_t ring = fifo_ring_length(rows[width].frames, distinct);
+        size_t cost = per_capacity + ring * sizeof(int);
+        if (used + cost > FIFO_SWEEP_BUDGET)
+            break;
+        used += cost;
+        *ring_total += ring;
+        width++;
+    }
+    return width;
+}
+
+// Run FIFO for the frame count of every row, sharing each pass over the
+// trace between as many capacities as fit in FIFO_SWEEP_BUDGET (page state
+// and insertion rings together)
+// With f frames the resident pages are exactly the last f pages inserted,
+// so a page is resident iff it was inserted after fault (faults - f); no
+// search is needed. State is laid out [page][capacity] so one reference
+// touches a single contiguous run for every capacity in the block.
+// Falls back to one run_fifo() for a row whose capacity alone does not
+// fit the budget, and for every row when the rows model the write-back
+// pipeline (which needs each eviction in order).
+// Returns 0 on success, -1 on allocation failure
+static int run_fifo_sweep(const Trace *trace, SimRow *rows, int count)
+{
+    int distinct = trace->universe;
+    if (count > 0 && rows[0].flush)
+        return run_each_row(trace, rows, count, run_fifo);
+
+    int block = 0;         // Widest block
+    size_t ring_size = 0;  // Largest total ring length of any block
+    for (int first = 0, width; first < count; first += (width > 0) ? width : 1)
+    {
+        size_t total;
+        width = fifo_sweep_block(rows + first, count - first, distinct, &total);
+        if (width > block)
+            block = width;
+        if (total > ring_size)
+            ring_size = total;
+    }
+    if (block == 0)
+        return run_each_row(trace, rows, count, run_fifo);
+
+    int *inserted = malloc(sizeof(int) * (size_t)distinct * block);  // Fault number of last insertion, 0 = never
+    unsigned char *dirty = malloc((size_t)distinct * block);
+    int *ring = malloc(sizeof(int) * (ring_size > 0 ? ring_size : 1));  // Insertion ring of each capacity
+    int *ring_base = malloc(sizeof(int) * block);  // Start of each capacity's ring
+    int *cursor = malloc(sizeof(int) * block);     // Next ring slot of each capacity
+    int *faults = malloc(sizeof(int) * block);
+    int *written = malloc(sizeof(int) * block);
+    if (!inserted || !dirty || !ring || !ring_base || !cursor || !faults || !written)
+    {
+        free(inserted);
+        free(dirty);
+        free(ring);
+        free(ring_base);
+        free(cursor);
+        free(faults);
+        free(written);
+        return -1;
+    }
+
+    int status = 0;
+    for (int first = 0, width; first < count; first += width)
+    {
+        size_t total;
+        SimRow *batch = rows + first;
+        width = fifo_sweep_block(batch, count - first, distinct, &total);
+        if (width == 0)
+        {
+            // This capacity alone is over the budget
+            width = 1;
+            if (run_each_row(trace, batch, 1, run_fifo) != 0)
+            {
+                status = -1;
+                break;
+            }
+            continue;
+        }
+
+        memset(inserted, 0, sizeof(int) * (size_t)distinct * width);
+        for (int k = 0, base = 0; k < width; k++)
+        {
+            ring_base[k] = base;
+            base += (int)fifo_ring_length(batch[k].frames, distinct);
+            cursor[k] = 0;
+            faults[k] = 0;
+            written[k] = 0;
+        }
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            int *ins = inserted + (size_t)trace->pages[i].page * width;
+            unsigned char *drt = dirty + (size_t)trace->pages[i].page * width;
+            int d = trace->pages[i].dirty;
+
+            for (int k = 0; k < width; k++)
+            {
+                int f = batch[k].frames;
+                int len = (int)fifo_ring_length(f, distinct);
+
+                if (ins[k] != 0 && ins[k] > faults[k] - f)
+                {
+                    // Page hit - mark as dirty if current reference is dirty
+                    if (d == 1)
+                        drt[k] = 1;
+                    continue;
+                }
+
+                // Page fault - the ring slot holds the page inserted f faults
+                // ago (rings shorter than f never fill: then nothing is evicted)
+                int *slot = ring + ring_base[k] + cursor[k];
+                if (faults[k] >= f && dirty[(size_t)*slot * width + k] == 1)
+                    written[k]++;
+
+                faults[k]++;
+                *slot = trace->pages[i].page;
+                ins[k] = faults[k];
+                drt[k] = (unsigned char)d;
+                if (++cursor[k] == len)
+                    cursor[k] = 0;
+            }
+        }
+
+        for (int k = 0; k < width; k++)
+        {
+            batch[k].page_faults = faults[k];
+            batch[k].write_backs = written[k];
+        }
+    }
+
+    free(inserted);
+    free(dirty);
+    free(ring);
+    free(ring_base);
+    free(cursor);
+    free(faults);
+    free(written);
+    return status;
+}
+
+//  OPT Algorithm Functions 
+
+// Build next_use[] with one backward pass over pages[]
+// Returns 0 on success, -1 on allocation failure
+static int build_next_use(Trace *trace)
+{
+    trace->next_use = malloc(sizeof(int) * (trace->count > 0 ? trace->count : 1));
+    if (!trace->next_use) return -1;
+
+    // Index of the most recent (later) occurrence of every page seen so far
+    int *last_seen = create_page_array(trace);
+    if (!last_seen)
+    {
+        free(trace->next_use);
+        trace->next_use = NULL;
+        return -1;
+    }
+
+    for (int i = trace->count - 1; i >= 0; i--)
+    {
+        int later = last_seen[trace->pages[i].page];
+        trace->next_use[i] = (later == -1) ? INT_MAX : later;
+        last_seen[trace->pages[i].page] = i;
+    }
+
+    free(last_seen);
+    return 0;
+}
+
+
+// Create a frame list with given capacity
+static FrameList *create_frameList(const Trace *trace, int capacity)
+{
+    FrameList *fl = malloc(sizeof(*fl));
+    if (!fl) return NULL;
+
+    fl->frame = malloc(sizeof(Page) * capacity);
+    fl->order = malloc(sizeof(int) * capacity);
+    fl->next = malloc(sizeof(int) * capacity);
+    fl->heap = malloc(sizeof(int) * capacity);
+    fl->heap_pos = malloc(sizeof(int) * capacity);
+    fl->slot_of = create_page_array(trace);
+    
+    if (!fl->frame || !fl->order || !fl->next || !fl->heap || !fl->heap_pos || !fl->slot_of)
+    {
+        free(fl->frame);
+        free(fl->order);
+        free(fl->next);
+        free(fl->heap);
+        free(fl->heap_pos);
+        free(fl->slot_of);
+        free(fl);
+        return NULL;
+    }
+
+    fl->capacity = capacity;
+    fl->size = 0;
+
+    return fl;
+}
+
+// Free frame list memory
+static void free_frameList(FrameList *fl)
+{
+    if (!fl) return;
+    free(fl->frame);
+    free(fl->order);
+    free(fl->next);
+    free(fl->heap);
+    free(fl->heap_pos);
+    free(fl->slot_of);
+    free(fl);
+}
+
+// Heap priority: farthest next use first, oldest insertion breaks ties
+static int opt_before(const FrameList *fl, int a, int b)
+{
+    if (fl->next[a] != fl->next[b])
+        return fl->next[a] > fl->next[b];
+    return fl->order[a] < fl->order[b];
+}
+
+// Swap two heap positions and keep heap_pos in sync
+static void opt_heap_swap(FrameList *fl, int i, int j)
+{
+    int a = fl->heap[i];
+    int b = fl->heap[j];
+    fl->heap[i] = b;
+    fl->heap[j] = a;
+    fl->heap_pos[b] = i;
+    fl->heap_pos[a] = j;
+}
+
+// Move a heap entry towards the root while it outranks its parent
+static void opt_sift_up(FrameList *fl, int i)
+{
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        if (!opt_before(fl, fl->heap[i], fl->heap[parent]))
+            break;
+        opt_heap_swap(fl, i, parent);
+        i = parent;
+    }
+}
+
+// Move a heap entry towards the leaves while a child outranks it
+static void opt_sift_down(FrameList *fl, int i)
+{
+    while (1)
+    {
+        int best = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+
+        if (left < fl->size && opt_before(fl, fl->heap[left], fl->heap[best]))
+            best = left;
+        if (right < fl->size && opt_before(fl, fl->heap[right], fl->heap[best]))
+            best = right;
+        if (best == i)
+            break;
+        opt_heap_swap(fl, i, best);
+        i = best;
+    }
+}
+
+// Run OPT with f frames over the whole trace (requires next_use[])
+// Hits are found through slot_of[] and the victim is the heap root,
+// so each reference costs O(log f) regardless of the frame count
+// Returns 0 on success, -1 on allocation failure
+static int run_opt(const Trace *trace, int f, int *page_faults, int *write_backs, FlushPipe *pipe)
+{
+    FrameList *fl = create_frameList(trace, f);
+    if (!fl) return -1;
+
+    int timestamp = 0;  // Tracks insertion order for tie-breaking
+    *page_faults = 0;
+    *write_backs = 0;
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        int pg = trace->pages[i].page;
+        int d = trace->pages[i].dirty;
+        int hit = fl->slot_of[pg];
+
+        if (hit != -1)
+        {
+            // Page hit - update dirty bit and push its next use further out
+            if (d == 1)
+                fl->frame[hit].dirty = 1;
+            fl->next[hit] = trace->next_use[i];
+            opt_sift_up(fl, fl->heap_pos[hit]);
+            continue;
+        }
+
+        // Page fault
+        (*page_faults)++;
+
+        if (fl->size < fl->capacity)
+        {
+            // Frames not full - add at the bottom of the heap
+            int slot = fl->size++;
+            fl->frame[slot].page = pg;
+            fl->frame[slot].dirty = d;
+            fl->order[slot] = timestamp++;
+            fl->next[slot] = trace->next_use[i];
+            fl->heap[slot] = slot;
+            fl->heap_pos[slot] = slot;
+            fl->slot_of[pg] = slot;
+            opt_sift_up(fl, slot);
+        }
+        else
+        {
+            // Frames full - the heap root is used farthest in the future
+            int victim = fl->heap[0];
+            if (fl->frame[victim].dirty == 1)
+                (*write_backs)++;
+            if (pipe)
+                flush_evict(pipe, i, fl->frame[victim].page);
+
+            fl->slot_of[fl->frame[victim].page] = -1;
+            fl->frame[victim].page = pg;
+            fl->frame[victim].dirty = d;
+            fl->order[victim] = timestamp++;
+            fl->next[victim] = trace->next_use[i];
+            fl->slot_of[pg] = victim;
+            opt_sift_down(fl, 0);
+        }
+    }
+
+    free_frameList(fl);
+    return 0;
+}
+
+// Compute the OPT fault count for every frame count 1..max_frames in a
+// single pass (requires next_use[])
+// OPT is a stack algorithm: the pages held with f frames are always the top
+// f entries of one priority stack ordered by next use, so a reference found
+// at depth d hits for every f >= d. Only the top max_frames entries matter,
+// so each reference costs O(max_frames) however many sizes are reported.
+// Fault counts do not depend on how ties between never-reused pages are
+// broken, so they match run_opt() exactly. Write-backs do depend on it.
+// faults[] must hold max_frames + 1 entries; faults[f] is filled for f >= 1
+// Returns 0 on success, -1 on allocation failure
+static int run_opt_curve(const Trace *trace, int max_frames, int *faults)
+{
+    int *stack_page = malloc(sizeof(int) * max_frames);
+    int *stack_next = malloc(sizeof(int) * max_frames);
+    int *depth_hits = calloc(max_frames + 1, sizeof(int));  // Hits at each depth
+    unsigned char *on_stack = calloc(trace->universe > 0 ? trace->universe : 1, 1);
+
+    if (!stack_page || !stack_next || !depth_hits || !on_stack)
+    {
+        free(stack_page);
+        free(stack_next);
+        free(depth_hits);
+        free(on_stack);
+        return -1;
+    }
+
+    int size = 0;
+    for (int i = 0; i < trace->count; i++)
+    {
+        int pg = trace->pages[i].page;
+        int pos = -1;
+
+        // Find the current stack depth of the page (misses need no search)
+        for (int j = 0; on_stack[pg] && j < size; j++)
+        {
+            if (stack_page[j] == pg)
+            {
+                pos = j;
+                break;
+            }
+        }
+        on_stack[pg] = 1;
+        if (pos != -1)
+            depth_hits[pos + 1]++;
+
+        if (size == 0)
+        {
+            stack_page[0] = pg;
+            stack_next[0] = trace->next_use[i];
+            size = 1;
+            continue;
+        }
+
+        // Referenced page goes on top; the old top is carried down and at
+        // each level the entry used later is the one that keeps moving
+        int carry_page = stack_page[0];
+        int carry_next = stack_next[0];
+        stack_page[0] = pg;
+        stack_next[0] = trace->next_use[i];
+        if (pos == 0)
+            continue;
+
+        int limit = (pos == -1) ? size : pos;
+        for (int j = 1; j < limit; j++)
+        {
+            if (stack_next[j] > carry_next)
+            {
+                int tmp_page = stack_page[j];
+                int tmp_next = stack_next[j];
+                stack_page[j] = carry_page;
+                stack_next[j] = carry_next;
+                carry_page = tmp_page;
+                carry_next = tmp_next;
+            }
+        }
+
+        if (pos != -1)
+        {
+            // Carried entry fills the referenced page's old level
+            stack_page[pos] = carry_page;
+            stack_next[pos] = carry_next;
+        }
+        else if (size < max_frames)
+        {
+            stack_page[size] = carry_page;
+            stack_next[size] = carry_next;
+            size++;
+        }
+        else
+        {
+            // The carried page falls out of every tracked frame count
+            on_stack[carry_page] = 0;
+        }
+    }
+
+    // Faults with f frames are all references that did not hit within depth f
+    int hits = 0;
+    for (int f = 1; f <= max_frames; f++)
+    {
+        hits += depth_hits[f];
+        faults[f] = trace->count - hits;
+    }
+
+    free(stack_page);
+    free(stack_next);
+    free(depth_hits);
+    free(on_stack);
+    return 0;
+}
+
+//  LRU Algorithm Functions 
+
+// Add delta at position pos of a Fenwick tree with n entries
+static void fenwick_add(int *tree, int n, int pos, int delta)
+{
+    for (int i = pos + 1; i <= n; i += i & -i)
+        tree[i] += delta;
+}
+
+// Sum of positions 0..pos of a Fenwick tree (0 when pos < 0)
+static int fenwick_sum(const int *tree, int pos)
+{
+    int sum = 0;
+    for (int i = pos + 1; i > 0; i -= i & -i)
+        sum += tree[i];
+    return sum;
+}
+
+// Compute LRU faults and write-backs for every frame count 1..max_frames in
+// a single pass (Mattson stack distances)
+// Every page has a marker at the time slot of its last access in a Fenwick
+// tree, so the stack distance of a reference is the number of markers after
+// the page's previous slot. Slots are renumbered once 2U of them are used,
+// which keeps the tree at O(U) entries and each reference at O(log U).
+// A dirty reference is written back with f frames iff the page is evicted
+// before its next dirty reference, i.e. iff some later reference (or the
+// final stack depth) up to then has a distance greater than f.
+// faults[] and write_backs[] must hold max_frames + 1 entries
+// Returns 0 on success, -1 on allocation failure
+static int run_lru_curve(const Trace *trace, int max_frames, int *faults, int *write_backs)
+{
+    int distinct = trace->universe;
+    int slots = 2 * distinct + 1;
+    int *tree = calloc(slots + 1, sizeof(int));
+    int *slot_owner = malloc(sizeof(int) * slots);      // Page whose marker is in each slot
+    int *last_slot = malloc(sizeof(int) * (distinct + 1));  // Slot of each page's last access
+    int *pending = malloc(sizeof(int) * (distinct + 1));    // Largest distance since last dirty reference
+    int *depth_hits = calloc(max_frames + 2, sizeof(int));
+    int *dirty_span = calloc(max_frames + 2, sizeof(int));  // Dirty intervals by largest distance
+
+    if (!tree || !slot_owner || !last_slot || !pending || !depth_hits || !dirty_span)
+    {
+        free(tree);
+        free(slot_owner);
+        free(last_slot);
+        free(pending);
+        free(depth_hits);
+        free(dirty_span);
+        return -1;
+    }
+
+    for (int p = 0; p < distinct; p++)
+    {
+        last_slot[p] = -1;
+        pending[p] = -1;
+    }
+
+    int now = 0;  // Next free time slot
+    for (int i = 0; i < trace->count; i++)
+    {
+        int p = trace->pages[i].page;
+
+        if (now == slots)
+        {
+            // Out of slots: renumber live markers 0..k-1 keeping their order
+            int k = 0;
+            for (int t = 0; t < slots; t++)
+            {
+                if (slot_owner[t] != -1)
+                {
+                    slot_owner[k] = slot_owner[t];
+                    last_slot[slot_owner[k]] = k;
+                    k++;
+                }
+            }
+            for (int t = k; t < slots; t++)
+                slot_owner[t] = -1;
+
+            // Rebuild the tree with ones in slots 0..k-1 in linear time
+            for (int t = 1; t <= slots; t++)
+                tree[t] = (t <= k) ? 1 : 0;
+            for (int t = 1; t <= slots; t++)
+            {
+                int parent = t + (t & -t);
+                if (parent <= slots)
+                    tree[parent] += tree[t];
+            }
+            now = k;
+        }
+
+        // Stack distance, capped at max_frames + 1 (a miss for every size)
+        int distance = max_frames + 1;
+        if (last_slot[p] != -1)
+        {
+            int d = fenwick_sum(tree, now - 1) - fenwick_sum(tree, last_slot[p]) + 1;
+            if (d <= max_frames)
+                distance = d;
+            fenwick_add(tree, slots, last_slot[p], -1);
+            slot_owner[last_slot[p]] = -1;
+        }
+        depth_hits[distance]++;
+
+        // Track evictions since the page was last dirtied
+        if (pending[p] != -1 && distance > pending[p])
+            pending[p] = distance;
+        if (trace->pages[i].dirty == 1)
+        {
+            if (pending[p] != -1)
+                dirty_span[pending[p]]++;
+            pending[p] = 0;
+        }
+
+        fenwick_add(tree, slots, now, 1);
+        slot_owner[now] = p;
+        last_slot[p] = now;
+        now++;
+    }
+
+    // Pages still dirty at the end are written back only if already evicted
+    int total = fenwick_sum(tree, now - 1);
+    for (int p = 0; p < distinct; p++)
+    {
+        if (pending[p] == -1)
+            continue;
+        int d = total - fenwick_sum(tree, last_slot[p]) + 1;
+        if (d > max_frames)
+            d = max_frames + 1;
+        dirty_span[d > pending[p] ? d : pending[p]]++;
+    }
+
+    int hits = 0;
+    int written = 0;
+    for (int f = 1; f <= max_frames; f++)
+    {
+        hits += depth_hits[f];
+        faults[f] = trace->count - hits;
+    }
+    for (int f = max_frames; f >= 1; f--)
+    {
+        written += dirty_span[f + 1];
+        write_backs[f] = written;
+    }
+
+    free(tree);
+    free(slot_owner);
+    free(last_slot);
+    free(pending);
+    free(depth_hits);
+    free(dirty_span);
+    return 0;
+}
+// Run LRU with f frames over the whole trace, reporting evictions to pipe
+// (NULL for none); used instead of the curve when evictions must be seen
+// in order. Resident pages form one recency list threaded through
+// page-indexed links, so each reference costs O(1).
+// Returns 0 on success, -1 on allocation failure
+static int run_lru(const Trace *trace, int f, int *page_faults, int *write_backs, FlushPipe *pipe)
+{
+    int *prev = create_page_array(trace);
+    int *next = create_page_array(trace);
+    int *state = create_page_array(trace);  // Page -> dirty bit, -1 when not resident
+    if (!prev || !next || !state)
+    {
+        free(prev);
+        free(next);
+        free(state);
+        return -1;
+    }
+
+    int mru = -1, lru = -1, size = 0;
+    *page_faults = 0;
+    *write_backs = 0;
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        int p = trace->pages[i].page;
+        int d = trace->pages[i].dirty;
+
+        if (state[p] != -1)
+        {
+            // Page hit - move it to the MRU end
+            if (d == 1)
+                state[p] = 1;
+            if (p == mru)
+                continue;
+            next[prev[p]] = next[p];
+            if (next[p] != -1) prev[next[p]] = prev[p]; else lru = prev[p];
+        }
+        else
+        {
+            (*page_faults)++;
+            if (size == f)
+            {
+                // Frames full - evict the LRU end
+                int victim = lru;
+                if (state[victim] == 1)
+                    (*write_backs)++;
+                if (pipe)
+                    flush_evict(pipe, i, victim);
+                state[victim] = -1;
+                lru = prev[victim];
+                if (lru != -1) next[lru] = -1; else mru = -1;
+            }
+            else
+            {
+                size++;
+            }
+            state[p] = d;
+        }
+
+        prev[p] = -1;
+        next[p] = mru;
+        if (mru != -1) prev[mru] = p; else lru = p;
+        mru = p;
+    }
+
+    free(prev);
+    free(next);
+    free(state);
+    return 0;
+}
+
+// Clock Algorithm Functions
+
+// Create a clock frame list with given capacity
+// frame_of is a caller-owned page index (every entry -1) read with the
+// given stride, so several lists can interleave their entries in one array.
+// Lists of up to SIMD_PROBE_MAX frames pass NULL and are probed instead.
+
+static ClockFrameList *create_clock_frameList(int capacity, int *frame_of, int stride)
+{
+    ClockFrameList *cfl = malloc(sizeof(*cfl));
+    if (!cfl) return NULL;
+
+    cfl->frame = malloc(sizeof(ClockPage) * capacity);
+    cfl->frame_pages = malloc(sizeof(int) * capacity);
+    if (!cfl->frame || !cfl->frame_pages)
+    {
+        free(cfl->frame);
+        free(cfl->frame_pages);
+        free(cfl);
+        return NULL;
+    }
+
+    cfl->frame_of = frame_of;
+    cfl->stride = stride;
+    cfl->capacity = capacity;
+    cfl->size = 0;
+    cfl->hand = 0;
+    cfl->epoch = 0;
+    
+    // Initialize all frames
+    for (int i = 0; i < capacity; i++)
+    {
+        cfl->frame[i].page = -1;
+        cfl->frame[i].dirty = 0;
+        cfl->frame[i].ref_bits = 0;
+        cfl->frame[i].epoch = 0;
+        cfl->frame[i].last_use = -1;
+        cfl->frame_pages[i] = -1;
+    }
+    
+    return cfl;
+}
+
+// Free clock frame list memory
+static void free_clock_frameList(ClockFrameList *cfl)
+{
+    if (!cfl) return;
+    free(cfl->frame);
+    free(cfl->frame_pages);
+    free(cfl);
+}
+
+// Check if page exists in clock frames and return its index
+static int contains_clock_frame(ClockFrameList *cfl, int pageNum, int *index)
+{
+    int i = cfl->frame_of ? cfl->frame_of[(size_t)pageNum * cfl->stride]
+                          : probe_frames(cfl->frame_pages, cfl->size, pageNum);
+    if (i == -1)
+        return 0;
+
+    if (index) *index = i;
+    return 1;
+}
+
+// Bring a frame's reference register up to date with the shift epoch
+// Shifts are only recorded as an epoch count and applied here, when the
+// register is next read or written
+static unsigned int current_reference_bits(ClockFrameList *cfl, int index)
+{
+    ClockPage *cp = &cfl->frame[index];
+    int pending = cfl->epoch - cp->epoch;
+
+    if (pending > 0)
+    {
+        cp->ref_bits = (pending >= 32) ? 0 : cp->ref_bits >> pending;
+        cp->epoch = cfl->epoch;
+    }
+    return cp->ref_bits;
+}
+
+// Shift all reference registers right by 1 bit (applied lazily)
+static void shift_reference_bits(ClockFrameList *cfl, int n)
+{
+    cfl->epoch++;
+}
+
+// Set the leftmost  bit of the reference register to 1
+static void set_reference_bit(ClockFrameList *cfl, int index, int n)
+{
+    unsigned int mask = 1U << (n - 1); 
+    current_reference_bits(cfl, index);
+    cfl->frame[index].ref_bits |= mask;  // Using bitmask with OR to set the bit
+}
+
+// Put a page into a frame with only its newest reference bit set
+static void place_clock_page(ClockFrameList *cfl, int index, int pageNum, int dirty, int n)
+{
+    ClockPage *cp = &cfl->frame[index];
+
+    if (cfl->frame_of)
+    {
+        if (cp->page != -1)
+            cfl->frame_of[(size_t)cp->page * cfl->stride] = -1;
+        cfl->frame_of[(size_t)pageNum * cfl->stride] = index;
+    }
+    cfl->frame_pages[index] = pageNum;
+
+    cp->page = pageNum;
+    cp->dirty = dirty;
+    cp->ref_bits = 0;
+    cp->epoch = cfl->epoch;
+    set_reference_bit(cfl, index, n);
+}
+
+// Mask covering an n-bit reference register
+// (1U << 32) - 1 is undefined; x86 evaluates it as 0 and every CLK result
+// so far was produced that way, so n = 32 keeps an empty mask
+static unsigned int reference_mask(int n)
+{
+    return (n >= 32) ? 0 : (1U << n) - 1;
+}
+
+// Find victim page using Second Chance algorithm
+// Returns the index of the page to be replaced
+static int find_victim_clock(ClockFrameList *cfl, int n)
+{
+    // Create mask for n bits (all 1s for n bits)
+    unsigned int n_bit_mask = reference_mask(n);
+    int start_hand = cfl->hand;  // Hand points towards a frame currently being examined
+    int hand = start_hand;
+    
+    while (1)
+    {
+        int next = (hand + 1 == cfl->size) ? 0 : hand + 1;
+
+        // Check if all reference bits are 0
+        if ((current_reference_bits(cfl, hand) & n_bit_mask) == 0)
+        {
+            // Found victim with all 0s
+            cfl->hand = next;
+            return hand;
+        }
+        
+        // Give second chance: shift right by 1
+        cfl->frame[hand].ref_bits >>= 1;
+        hand = next;
+        
+        // Prevent infinite loop (safety check)
+        if (hand == start_hand)
+        {
+            // If we've gone full circle, just pick current position
+            cfl->hand = (hand + 1 == cfl->size) ? 0 : hand + 1;
+            return hand;
+        }
+    }
+}
+
+// Most Second Chance configurations simulated in lockstep by one pass
+#define CLOCK_BATCH 16
+
+// Memory budget for the shared page index of one lockstep batch
+#define CLOCK_BATCH_BUDGET (64 << 20)
+
+// Run Second Chance for every row's (frames, n, m) in lockstep
+// Each reference is loaded once and fed to every configuration before the
+// next one; the configurations' page index entries sit side by side, so a
+// reference touches one contiguous run of the index for the whole batch.
+// With probe_small set, configurations of up to SIMD_PROBE_MAX frames are
+// probed and take no index column.
+// Rows that model the write-back pipeline each get their own.
+// count must not exceed CLOCK_BATCH
+// Returns 0 on success, -1 on allocation failure
+static int run_clock_batch(const Trace *trace, SimRow *rows, int count, int probe_small)
+{
+    ClockFrameList *cfl[CLOCK_BATCH];
+    FlushPipe *pipe[CLOCK_BATCH];
+    int ref_counter[CLOCK_BATCH];  // Counters for shifting reference bits
+
+    // Only configurations that are not probed get a column of the index
+    int indexed = 0;
+    for (int k = 0; k < count; k++)
+    {
+        if (!probe_small || rows[k].frames > SIMD_PROBE_MAX)
+            indexed++;
+    }
+
+    size_t entries = (size_t)(trace->universe > 0 ? trace->universe : 1) * indexed;
+    int *frame_of = indexed ? malloc(sizeof(int) * entries) : NULL;
+    int built = 0;
+
+    if (frame_of || !indexed)
+    {
+        int column = 0;
+        for (size_t e = 0; e < entries; e++)
+            frame_of[e] = -1;
+        for (built = 0; built < count; built++)
+        {
+            int probed = probe_small && rows[built].frames <= SIMD_PROBE_MAX;
+            cfl[built] = create_clock_frameList(rows[built].frames,
+                                                probed ? NULL : frame_of + column++, indexed);
+            pipe[built] = create_flush_pipe(trace, rows[built].flush);
+            if (!cfl[built] || (rows[built].flush && !pipe[built]))
+            {
+                free_clock_frameList(cfl[built]);
+                free_flush_pipe(pipe[built]);
+                break;
+            }
+            ref_counter[built] = 0;
+            rows[built].page_faults = 0;
+            rows[built].write_backs = 0;
+        }
+    }
+    if (built < count)
+    {
+        for (int k = 0; k < built; k++)
+        {
+            free_clock_frameList(cfl[k]);
+            free_flush_pipe(pipe[k]);
+        }
+        free(frame_of);
+        return -1;
+    }
+
+    // Process each page reference for every configuration
+    for (int i = 0; i < trace->count; i++)
+    {
+        int current_page = trace->pages[i].page;
+        int current_dirty = trace->pages[i].dirty;
+
+        for (int k = 0; k < count; k++)
+        {
+            ClockFrameList *list = cfl[k];
+            int n = rows[k].n;
+            int page_index = -1;
+
+            // Check if page is already in memory
+            if (contains_clock_frame(list, current_page, &page_index))
+            {
+                // Page hit - set reference bit and update dirty flag
+                set_reference_bit(list, page_index, n);
+                if (current_dirty == 1)
+                    list->frame[page_index].dirty = 1;
+            }
+            else
+            {
+                // Page fault
+                rows[k].page_faults++;
+
+                if (list->size < list->capacity)
+                {
+                    // Frames not full - just add the page
+                    place_clock_page(list, list->size, current_page, current_dirty, n);
+                    list->size++;
+                }
+                else
+                {
+                    // Frames full - find a victim page
+                    int victim_idx = find_victim_clock(list, n);
+
+                    // Write back if victim page is dirty
+                    if (list->frame[victim_idx].dirty == 1)
+                        rows[k].write_backs++;
+                    if (pipe[k])
+                        flush_evict(pipe[k], i, list->frame[victim_idx].page);
+
+                    // Replace victim with new page
+                    place_clock_page(list, victim_idx, current_page, current_dirty, n);
+                }
+            }
+
+            // Shift reference bits after m references
+            if (++ref_counter[k] >= rows[k].m)
+            {
+                shift_reference_bits(list, n);
+                ref_counter[k] = 0;
+            }
+        }
+    }
+
+    for (int k = 0; k < count; k++)
+    {
+        free_clock_frameList(cfl[k]);
+        finish_flush_pipe(pipe[k], &rows[k]);
+    }
+    free(frame_of);
+    return 0;
+}
+
+//  Enhanced Second Chance Functions 
+
+// List an ESC frame is on: the clock ring still being aged by the hand, or
+// the clean or dirty candidates (register all zero, waiting for eviction)
+enum { ESC_RING, ESC_CLEAN, ESC_DIRTY, ESC_LISTS };
+
+// Enhanced Second Chance state for one configuration
+// Pages, registers and the page index are a ClockFrameList; every frame is
+// also on one circular list, so the hand never revisits candidates and
+// finding a clean victim takes at most one revolution of the ring
+typedef struct
+{
+    ClockFrameList *cfl;
+    int *prev;             // Frame links within its list
+    int *next;
+    unsigned char *where;  // ESC_* list of each frame
+    int head[ESC_LISTS];   // Ring: frame under the hand; candidates: oldest
+    int size[ESC_LISTS];
+    double credit;         // Budget saved up; 1 allows a dirty eviction
+} EscState;
+
+// Create ESC state with given capacity over the trace's pages
+static EscState *create_esc_state(const Trace *trace, int capacity)
+{
+    EscState *esc = malloc(sizeof(*esc));
+    if (!esc) return NULL;
+
+    int *frame_of = create_page_array(trace);
+    esc->cfl = frame_of ? create_clock_frameList(capacity, frame_of, 1) : NULL;
+    esc->prev = malloc(sizeof(int) * capacity);
+    esc->next = malloc(sizeof(int) * capacity);
+    esc->where = malloc(capacity);
+    if (!esc->cfl || !esc->prev || !esc->next || !esc->where)
+    {
+        free_clock_frameList(esc->cfl);
+        free(frame_of);
+        free(esc->prev);
+        free(esc->next);
+        free(esc->where);
+        free(esc);
+        return NULL;
+    }
+
+    for (int l = 0; l < ESC_LISTS; l++)
+    {
+        esc->head[l] = -1;
+        esc->size[l] = 0;
+    }
+    esc->credit = 0;
+    return esc;
+}
+
+// Free ESC state memory
+static void free_esc_state(EscState *esc)
+{
+    if (!esc) return;
+    free(esc->cfl->frame_of);
+    free_clock_frameList(esc->cfl);
+    free(esc->prev);
+    free(esc->next);
+    free(esc->where);
+    free(esc);
+}
+
+// Take a frame off its list; a hand (or head) on it moves to the next frame
+static void esc_unlink(EscState *esc, int x)
+{
+    int l = esc->where[x];
+
+    if (--esc->size[l] == 0)
+        esc->head[l] = -1;
+    else
+    {
+        esc->next[esc->prev[x]] = esc->next[x];
+        esc->prev[esc->next[x]] = esc->prev[x];
+        if (esc->head[l] == x)
+            esc->head[l] = esc->next[x];
+    }
+}
+
+// Put a frame last on a list: behind the hand on the ring, newest candidate
+// on the candidate lists
+static void esc_append(EscState *esc, int l, int x)
+{
+    int head = esc->head[l];
+
+    if (head == -1)
+    {
+        esc->prev[x] = x;
+        esc->next[x] = x;
+        esc->head[l] = x;
+    }
+    else
+    {
+        esc->prev[x] = esc->prev[head];
+        esc->next[x] = head;
+        esc->next[esc->prev[head]] = x;
+        esc->prev[head] = x;
+    }
+    esc->where[x] = (unsigned char)l;
+    esc->size[l]++;
+}
+
+// Pick a victim frame, preferring clean pages whose registers are zero
+// The hand ages ring frames as in find_victim_clock() and moves those that
+// reach zero to the clean or dirty candidates. It stops at the first clean
+// candidate, or at a dirty one if the budget allows a write-back. After one
+// revolution the oldest dirty candidate is taken, or with none at all the
+// frame under the hand (as find_victim_clock() does)
+static int find_victim_esc(EscState *esc, int n, double budget)
+{
+    ClockFrameList *cfl = esc->cfl;
+    unsigned int n_bit_mask = reference_mask(n);
+    int steps = esc->size[ESC_RING];
+
+    esc->credit = (esc->credit + budget < 1) ? esc->credit + budget : 1;
+    int dirty_ok = (esc->credit >= 1);
+
+    while (esc->size[ESC_CLEAN] == 0 && !(dirty_ok && esc->size[ESC_DIRTY] > 0) && steps-- > 0)
+    {
+        int hand = esc->head[ESC_RING];
+
+        if ((current_reference_bits(cfl, hand) & n_bit_mask) == 0)
+        {
+            esc_unlink(esc, hand);
+            esc_append(esc, cfl->frame[hand].dirty == 1 ? ESC_DIRTY : ESC_CLEAN, hand);
+        }
+        else
+        {
+            // Give second chance: shift right by 1
+            cfl->frame[hand].ref_bits >>= 1;
+            esc->head[ESC_RING] = esc->next[hand];
+        }
+    }
+
+    int victim;
+    if (esc->size[ESC_CLEAN] > 0)
+        victim = esc->head[ESC_CLEAN];
+    else if (esc->size[ESC_DIRTY] > 0)
+        victim = esc->head[ESC_DIRTY];
+    else
+        victim = esc->head[ESC_RING];
+
+    if (cfl->frame[victim].dirty == 1)
+        esc->credit = 0;  // Spent, whether the budget allowed it or not
+    return victim;
+}
+
+// Run Enhanced Second Chance for one configuration over the whole trace
+// Returns 0 on success, -1 on allocation failure
+static int run_esc(const Trace *trace, SimRow *row)
+{
+    EscState *esc = create_esc_state(trace, row->frames);
+    FlushPipe *pipe = create_flush_pipe(trace, row->flush);
+    if (!esc || (row->flush && !pipe))
+    {
+        free_esc_state(esc);
+        free_flush_pipe(pipe);
+        return -1;
+    }
+
+    ClockFrameList *list = esc->cfl;
+    int n = row->n;
+    int ref_counter = 0;  // Counter for shifting reference bits
+
+    row->page_faults = 0;
+    row->write_backs = 0;
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        int current_page = trace->pages[i].page;
+        int current_dirty = trace->pages[i].dirty;
+        int page_index = -1;
+
+        if (contains_clock_frame(list, current_page, &page_index))
+        {
+            // Page hit - set reference bit and update dirty flag; a waiting
+            // candidate goes back on the ring behind the hand
+            set_reference_bit(list, page_index, n);
+            if (current_dirty == 1)
+                list->frame[page_index].dirty = 1;
+            if (esc->where[page_index] != ESC_RING)
+            {
+                esc_unlink(esc, page_index);
+                esc_append(esc, ESC_RING, page_index);
+            }
+        }
+        else
+        {
+            // Page fault
+            row->page_faults++;
+
+            if (list->size < list->capacity)
+                page_index = list->size++;
+            else
+            {
+                page_index = find_victim_esc(esc, n, row->wb_budget);
+                if (list->frame[page_index].dirty == 1)
+                    row->write_backs++;
+                if (pipe)
+                    flush_evict(pipe, i, list->frame[page_index].page);
+                esc_unlink(esc, page_index);
+            }
+
+            // The new page takes the victim's frame, behind the hand
+            place_clock_page(list, page_index, current_page, current_dirty, n);
+            esc_append(esc, ESC_RING, page_index);
+        }
+
+        // Shift reference bits after m references
+        if (++ref_counter >= row->m)
+        {
+            shift_reference_bits(list, n);
+            ref_counter = 0;
+        }
+    }
+
+    free_esc_state(esc);
+    finish_flush_pipe(pipe, row);
+    return 0;
+}
+
+//  Working Set Functions 
+
+// Working-set state for one configuration (WS and WSClock)
+// Pages live in a ClockFrameList whose frames carry their last-use time;
+// every resident frame is also on a recency list ordered by that time, so
+// the page that has gone longest without a reference is found in O(1)
+typedef struct
+{
+    ClockFrameList *cfl;
+    int *newer;      // Frame links along the recency list, -1 at the ends
+    int *older;
+    int newest;      // Ends of the recency list, -1 when empty
+    int oldest;
+    int free_frame;  // First unused frame, chained through newer (WS)
+} WsState;
+
+// Create working-set state with given capacity over the trace's pages
+static WsState *create_ws_state(const Trace *trace, int capacity)
+{
+    WsState *ws = malloc(sizeof(*ws));
+    if (!ws) return NULL;
+
+    int *frame_of = create_page_array(trace);
+    ws->cfl = frame_of ? create_clock_frameList(capacity, frame_of, 1) : NULL;
+    ws->newer = malloc(sizeof(int) * capacity);
+    ws->older = malloc(sizeof(int) * capacity);
+    if (!ws->cfl || !ws->newer || !ws->older)
+    {
+        free_clock_frameList(ws->cfl);
+        free(frame_of);
+        free(ws->newer);
+        free(ws->older);
+        free(ws);
+        return NULL;
+    }
+
+    for (int x = 0; x < capacity; x++)
+        ws->newer[x] = (x + 1 < capacity) ? x + 1 : -1;
+    ws->free_frame = 0;
+    ws->newest = -1;
+    ws->oldest = -1;
+    return ws;
+}
+
+// Free working-set state memory
+static void free_ws_state(WsState *ws)
+{
+    if (!ws) return;
+    free(ws->cfl->frame_of);
+    free_clock_frameList(ws->cfl);
+    free(ws->newer);
+    free(ws->older);
+    free(ws);
+}
+
+// Take a frame off the recency list
+static void ws_unlink(WsState *ws, int x)
+{
+    int o = ws->older[x], w = ws->newer[x];
+    if (o != -1) ws->newer[o] = w; else ws->oldest = w;
+    if (w != -1) ws->older[w] = o; else ws->newest = o;
+}
+
+// Stamp a frame as used by reference i and make it the newest
+static void ws_touch(WsState *ws, int x, int i, int resident)
+{
+    ws->cfl->frame[x].last_use = i;
+    if (ws->newest == x)
+        return;
+    if (resident)
+        ws_unlink(ws, x);
+    ws->older[x] = ws->newest;
+    ws->newer[x] = -1;
+    if (ws->newest != -1) ws->newer[ws->newest] = x; else ws->oldest = x;
+    ws->newest = x;
+}
+
+// Put a page into a frame
+static void ws_place(WsState *ws, int x, int pageNum, int dirty)
+{
+    ClockPage *cp = &ws->cfl->frame[x];
+
+    if (cp->page != -1)
+        ws->cfl->frame_of[cp->page] = -1;
+    ws->cfl->frame_of[pageNum] = x;
+    cp->page = pageNum;
+    cp->dirty = dirty;
+}
+
+// Run the working-set policy with window tau over the whole trace
+// A page stays resident while it was referenced within the last tau
+// references and leaves (written back if dirty) once it was not. At most
+// tau + 1 pages are ever resident, and each page joins and leaves the
+// recency list once per fault, so a reference costs O(1) amortized.
+// avg_resident is the mean of |W(i, tau)|, the distinct pages among
+// references i - tau + 1 .. i.
+// Returns 0 on success, -1 on allocation failure
+static int run_ws(const Trace *trace, SimRow *row)
+{
+    int tau = row->tau;
+    int capacity = (tau < trace->universe) ? tau + 1 : trace->universe;
+    WsState *ws = create_ws_state(trace, capacity > 0 ? capacity : 1);
+    FlushPipe *pipe = create_flush_pipe(trace, row->flush);
+    if (!ws || (row->flush && !pipe))
+    {
+        free_ws_state(ws);
+        free_flush_pipe(pipe);
+        return -1;
+    }
+
+    ClockFrameList *list = ws->cfl;
+    double resident = 0;
+    row->page_faults = 0;
+    row->write_backs = 0;
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        int current_page = trace->pages[i].page;
+        int current_dirty = trace->pages[i].dirty;
+        int x = -1;
+
+        // Pages unreferenced for more than tau references leave the working set
+        while (ws->oldest != -1 && i - list->frame[ws->oldest].last_use > tau)
+        {
+            int old = ws->oldest;
+            ClockPage *cp = &list->frame[old];
+            if (cp->dirty == 1)
+                row->write_backs++;
+            if (pipe)
+                flush_evict(pipe, i, cp->page);
+            ws_unlink(ws, old);
+            list->frame_of[cp->page] = -1;
+            cp->page = -1;
+            list->size--;
+            ws->newer[old] = ws->free_frame;
+            ws->free_frame = old;
+        }
+
+        int hit = contains_clock_frame(list, current_page, &x);
+        if (hit)
+        {
+            // Page hit - mark as dirty if current reference is dirty
+            if (current_dirty == 1)
+                list->frame[x].dirty = 1;
+        }
+        else
+        {
+            // Page fault - there is always a free frame
+            row->page_faults++;
+            x = ws->free_frame;
+            ws->free_frame = ws->newer[x];
+            ws_place(ws, x, current_page, current_dirty);
+            list->size++;
+        }
+        ws_touch(ws, x, i, hit);
+
+        // The page last used exactly tau references ago is outside W(i, tau)
+        resident += list->size - (i - list->frame[ws->oldest].last_use == tau);
+    }
+
+    row->avg_resident = (trace->count > 0) ? resident / trace->count : 0;
+    free_ws_state(ws);
+    finish_flush_pipe(pipe, row);
+    return 0;
+}
+
+// WSClock victim: sweep the hand for a page that has left the window
+// (last used more than tau references ago), scheduling the write-back of
+// old dirty pages it passes; a second revolution finds one of them clean.
+// When no page has left the window the least recently used one goes.
+// Hits stamp a frame's last use directly, so no reference bit is kept.
+// Returns the index of the page to be replaced
+static int find_victim_wsclock(WsState *ws, int now, int tau, FlushPipe *pipe, int *write_backs)
+{
+    ClockFrameList *cfl = ws->cfl;
+
+    if (now - cfl->frame[ws->oldest].last_use <= tau)
+        return ws->oldest;
+
+    for (;;)
+    {
+        int hand = cfl->hand;
+        ClockPage *cp = &cfl->frame[hand];
+        cfl->hand = (hand + 1) % cfl->capacity;
+
+        if (now - cp->last_use <= tau)
+            continue;
+        if (cp->dirty == 0)
+            return hand;
+
+        // Old but dirty: write it back and keep sweeping
+        (*write_backs)++;
+        if (pipe)
+            flush_evict(pipe, now, cp->page);
+        cp->dirty = 0;
+    }
+}
+
+// Run WSClock with the row's frames and window tau over the whole trace
+// avg_resident is the mean number of occupied frames
+// Returns 0 on success, -1 on allocation failure
+static int run_wsclock(const Trace *trace, SimRow *row)
+{
+    WsState *ws = create_ws_state(trace, row->frames);
+    FlushPipe *pipe = create_flush_pipe(trace, row->flush);
+    if (!ws || (row->flush && !pipe))
+    {
+        free_ws_state(ws);
+        free_flush_pipe(pipe);
+        return -1;
+    }
+
+    ClockFrameList *list = ws->cfl;
+    double resident = 0;
+    row->page_faults = 0;
+    row->write_backs = 0;
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        int current_page = trace->pages[i].page;
+        int current_dirty = trace->pages[i].dirty;
+        int x = -1;
+
+        int hit = contains_clock_frame(list, current_page, &x);
+        if (hit)
+        {
+            // Page hit - mark as dirty if current reference is dirty
+            if (current_dirty == 1)
+                list->frame[x].dirty = 1;
+        }
+        else
+        {
+            // Page fault
+            row->page_faults++;
+
+            if (list->size < list->capacity)
+                x = list->size++;
+            else
+            {
+                x = find_victim_wsclock(ws, i, row->tau, pipe, &row->write_backs);
+                if (list->frame[x].dirty == 1)
+                    row->write_backs++;
+                if (pipe)
+                    flush_evict(pipe, i, list->frame[x].page);
+                ws_unlink(ws, x);
+            }
+            ws_place(ws, x, current_page, current_dirty);
+        }
+        ws_touch(ws, x, i, hit);
+        resident += list->size;
+    }
+
+    row->avg_resident = (trace->count > 0) ? resident / trace->count : 0;
+    free_ws_state(ws);
+    finish_flush_pipe(pipe, row);
+    return 0;
+}
+
+//  CLOCK-Pro Algorithm Functions 
+
+// Status bits of a CLOCK-Pro ring entry
+#define CP_HOT      0x01  // Hot page (always resident)
+#define CP_RESIDENT 0x02  // Page occupies a frame
+#define CP_TEST     0x04  // Cold page in its test period
+#define CP_REF      0x08  // Reference bit
+#define CP_DIRTY    0x10  // Modified since it was loaded
+
+// The cold target never drops below 1/CP_COLD_MIN_DIV of the frames, so
+// HAND_cold passes about 2 * CP_COLD_MIN_DIV entries per fault at worst
+#define CP_COLD_MIN_DIV 32
+
+// Entry on the CLOCK-Pro ring: a resident page, or a non-resident cold page
+// still in its test period
+typedef struct
+{
+    int prev;             // Slot towards the list head (counter-clockwise)
+    int next;             // Slot the hands move to (clockwise)
+    int page;
+    unsigned char flags;  // CP_* bits
+} ClockProEntry;
+
+// CLOCK-Pro state for one cache size
+// The ClockFrameList ring swept by a hand, with three hands (hot, cold,
+// test) and non-resident entries; it is linked so pages can be placed at
+// the list head, just behind HAND_hot, in O(1)
+typedef struct
+{
+    int capacity;      // m, the number of frames
+    int cold_target;   // mc, adaptive number of resident cold pages
+    int cold_min;
+    int cold_max;
+    int hot;           // Hot pages
+    int resident;      // Resident pages, hot and cold
+    int non_resident;  // Non-resident cold pages in test
+    int hand_hot;      // Slot under each hand, -1 on an empty ring
+    int hand_cold;
+    int hand_test;
+    ClockProEntry *entry;  // Slot pool
+    int free_slot;         // First unused slot, chained through next
+    int *slot_of;          // Page -> slot, -1 when not on the ring
+} ClockProRing;
+
+// Create a CLOCK-Pro ring with given capacity over the trace's pages
+static ClockProRing *create_clockpro_ring(const Trace *trace, int capacity)
+{
+    ClockProRing *ring = malloc(sizeof(*ring));
+    if (!ring) return NULL;
+
+    // m resident pages plus up to m + 1 non-resident ones before HAND_test
+    int slots = 2 * capacity + 1;
+    ring->entry = malloc(sizeof(ClockProEntry) * slots);
+    ring->slot_of = create_page_array(trace);
+    if (!ring->entry || !ring->slot_of)
+    {
+        free(ring->entry);
+        free(ring->slot_of);
+        free(ring);
+        return NULL;
+    }
+
+    ring->capacity = capacity;
+    ring->cold_min = (capacity / CP_COLD_MIN_DIV > 1) ? capacity / CP_COLD_MIN_DIV : 1;
+    ring->cold_max = (capacity - 1 > ring->cold_min) ? capacity - 1 : ring->cold_min;
+    ring->cold_target = ring->cold_min;
+    ring->hot = 0;
+    ring->resident = 0;
+    ring->non_resident = 0;
+    ring->hand_hot = -1;
+    ring->hand_cold = -1;
+    ring->hand_test = -1;
+    for (int s = 0; s < slots; s++)
+        ring->entry[s].next = (s + 1 < slots) ? s + 1 : -1;
+    ring->free_slot = 0;
+    return ring;
+}
+
+// Free CLOCK-Pro ring memory
+static void free_clockpro_ring(ClockProRing *ring)
+{
+    if (!ring) return;
+    free(ring->entry);
+    free(ring->slot_of);
+    free(ring);
+}
+
+// Take a slot off the ring, moving any hand on it to the next entry
+static void clockpro_unlink(ClockProRing *ring, int s)
+{
+    int next = ring->entry[s].next;
+    int prev = ring->entry[s].prev;
+
+    if (next == s)
+        next = -1;  // Last entry
+    else
+    {
+        ring->entry[prev].next = next;
+        ring->entry[next].prev = prev;
+    }
+
+    if (ring->hand_hot == s) ring->hand_hot = next;
+    if (ring->hand_cold == s) ring->hand_cold = next;
+    if (ring->hand_test == s) ring->hand_test = next;
+}
+
+// Put a slot at the list head, just behind HAND_hot
+static void clockpro_insert_head(ClockProRing *ring, int s)
+{
+    if (ring->hand_hot == -1)
+    {
+        ring->entry[s].prev = s;
+        ring->entry[s].next = s;
+        ring->hand_hot = s;
+        ring->hand_cold = s;
+        ring->hand_test = s;
+        return;
+    }
+
+    int next = ring->hand_hot;
+    int prev = ring->entry[next].prev;
+    ring->entry[s].prev = prev;
+    ring->entry[s].next = next;
+    ring->entry[prev].next = s;
+    ring->entry[next].prev = s;
+}
+
+// Move a slot to the list head
+static void clockpro_move_head(ClockProRing *ring, int s)
+{
+    clockpro_unlink(ring, s);
+    clockpro_insert_head(ring, s);
+}
+
+// Remove a page from the ring and free its slot
+static void clockpro_remove(ClockProRing *ring, int s)
+{
+    clockpro_unlink(ring, s);
+    ring->slot_of[ring->entry[s].page] = -1;
+    ring->entry[s].next = ring->free_slot;
+    ring->free_slot = s;
+}
+
+// Adjust the cold target by delta within its bounds
+static void clockpro_adapt(ClockProRing *ring, int delta)
+{
+    int target = ring->cold_target + delta;
+    if (target < ring->cold_min) target = ring->cold_min;
+    if (target > ring->cold_max) target = ring->cold_max;
+    ring->cold_target = target;
+}
+
+// End the test period of a cold page that was not reused during it:
+// shrink the cold target and drop the page if it is non-resident
+// Returns 1 if the page left the ring
+static int clockpro_end_test(ClockProRing *ring, int s)
+{
+    ClockProEntry *e = &ring->entry[s];
+
+    e->flags &= ~CP_TEST;
+    clockpro_adapt(ring, -1);
+    if (e->flags & CP_RESIDENT)
+        return 0;
+
+    ring->non_resident--;
+    clockpro_remove(ring, s);
+    return 1;
+}
+
+// HAND_hot: turn unreferenced hot pages cold until the hot pages fit in
+// m - mc frames, clearing reference bits and ending test periods on the way
+static void clockpro_run_hand_hot(ClockProRing *ring)
+{
+    while (ring->hot > ring->capacity - ring->cold_target)
+    {
+        int s = ring->hand_hot;
+        ClockProEntry *e = &ring->entry[s];
+
+        if (e->flags & CP_HOT)
+        {
+            if (e->flags & CP_REF)
+                e->flags &= ~CP_REF;
+            else
+            {
+                e->flags &= ~CP_HOT;
+                ring->hot--;
+            }
+        }
+        else if ((e->flags & CP_TEST) && clockpro_end_test(ring, s))
+            continue;  // Removal already moved the hand on
+        ring->hand_hot = e->next;
+    }
+}
+
+// HAND_test: end test periods until at most m non-resident pages remain
+static void clockpro_run_hand_test(ClockProRing *ring)
+{
+    while (ring->non_resident > ring->capacity)
+    {
+        int s = ring->hand_test;
+        ClockProEntry *e = &ring->entry[s];
+
+        if ((e->flags & CP_TEST) && clockpro_end_test(ring, s))
+            continue;
+        ring->hand_test = e->next;
+    }
+}
+
+// HAND_cold: free a frame by evicting the first unreferenced cold page
+// Referenced cold pages go to the list head; those in their test period
+// become hot
+// Returns the evicted page
+static int clockpro_run_hand_cold(ClockProRing *ring, int *write_backs)
+{
+    for (;;)
+    {
+        int s = ring->hand_cold;
+        ClockProEntry *e = &ring->entry[s];
+
+        if ((e->flags & (CP_HOT | CP_RESIDENT)) != CP_RESIDENT)
+        {
+            ring->hand_cold = e->next;
+            continue;
+        }
+
+        if (e->flags & CP_REF)
+        {
+            e->flags &= ~CP_REF;
+            if (e->flags & CP_TEST)
+            {
+                // Reused within its test period: promote
+                e->flags = (e->flags & ~CP_TEST) | CP_HOT;
+                ring->hot++;
+                clockpro_adapt(ring, 1);
+                clockpro_move_head(ring, s);
+                clockpro_run_hand_hot(ring);
+            }
+            else
+            {
+                e->flags |= CP_TEST;
+                clockpro_move_head(ring, s);
+            }
+            continue;
+        }
+
+        // Evict: a page in its test period stays on as non-resident
+        if (e->flags & CP_DIRTY)
+            (*write_backs)++;
+        e->flags &= ~(CP_RESIDENT | CP_DIRTY);
+        ring->resident--;
+        ring->hand_cold = e->next;
+        int page = e->page;
+        if (e->flags & CP_TEST)
+            ring->non_resident++;
+        else
+            clockpro_remove(ring, s);
+        return page;
+    }
+}
+
+// Run CLOCK-Pro with f frames over the whole trace, reporting evictions to
+// pipe (NULL for none)
+// Returns 0 on success, -1 on allocation failure
+static int run_clockpro(const Trace *trace, int f, int *page_faults, int *write_backs, FlushPipe *pipe)
+{
+    ClockProRing *ring = create_clockpro_ring(trace, f);
+    if (!ring) return -1;
+
+    *page_faults = 0;
+    *write_backs = 0;
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        int pg = trace->pages[i].page;
+        int d = trace->pages[i].dirty;
+        int s = ring->slot_of[pg];
+
+        if (s != -1 && (ring->entry[s].flags & CP_RESIDENT))
+        {
+            // Page hit - only the reference (and dirty) bit changes
+            ring->entry[s].flags |= CP_REF | (d == 1 ? CP_DIRTY : 0);
+            continue;
+        }
+
+        // Page fault
+        (*page_faults)++;
+        int warming = (ring->resident < f);
+        if (!warming)
+        {
+            int victim = clockpro_run_hand_cold(ring, write_backs);
+            if (pipe)
+                flush_evict(pipe, i, victim);
+        }
+
+        // The sweep may have ended the page's test period
+        s = ring->slot_of[pg];
+        if (s != -1)
+        {
+            // Non-resident page reused within its test period: load it hot
+            ring->entry[s].flags = CP_HOT | CP_RESIDENT;
+            ring->non_resident--;
+            ring->hot++;
+            clockpro_adapt(ring, 1);
+            clockpro_move_head(ring, s);
+        }
+        else
+        {
+            // New page: cold and in test, or hot while the hot share fills
+            s = ring->free_slot;
+            ring->free_slot = ring->entry[s].next;
+            ring->entry[s].page = pg;
+            ring->slot_of[pg] = s;
+            ring->entry[s].flags = CP_RESIDENT;
+            if (warming && ring->hot < f - ring->cold_target)
+            {
+                ring->entry[s].flags |= CP_HOT;
+                ring->hot++;
+            }
+            else
+                ring->entry[s].flags |= CP_TEST;
+            clockpro_insert_head(ring, s);
+        }
+        ring->resident++;
+        if (d == 1)
+            ring->entry[s].flags |= CP_DIRTY;
+
+        clockpro_run_hand_hot(ring);
+        clockpro_run_hand_test(ring);
+    }
+
+    free_clockpro_ring(ring);
+    return 0;
+}
+
+//  LIRS Algorithm Functions 
+
+// Status bits of a LIRS page
+#define LIRS_LIR      0x01  // Low inter-reference recency (always resident)
+#define LIRS_RESIDENT 0x02  // Page occupies a frame
+#define LIRS_STACK    0x04  // On the recency stack S
+#define LIRS_QUEUE    0x08  // On the resident HIR queue Q
+#define LIRS_DIRTY    0x10  // Modified since it was loaded
+
+// Per-page LIRS state, packed so one reference touches one node
+typedef struct
+{
+    int stack_prev;  // Neighbour towards the top of S
+    int stack_next;  // Neighbour towards the bottom of S
+    int queue_prev;  // Neighbour towards the front of Q
+    int queue_next;  // Neighbour towards the end of Q
+    unsigned char flags;  // LIRS_* bits
+} LirsNode;
+
+// LIRS state for one cache size
+// S and Q are intrusive lists over page-indexed nodes, so moves are O(1);
+// stack pruning removes each entry at most once per push (amortized O(1))
+typedef struct
+{
+    int capacity;   // Frames
+    int lir_limit;  // Frames reserved for LIR pages
+    int lir;        // LIR pages
+    int resident;   // Resident pages, LIR and HIR
+    int top;        // Top of S (most recent), -1 when empty
+    int bottom;     // Bottom of S, always a LIR page after pruning
+    int front;      // Front of Q (next victim), -1 when empty
+    int back;       // End of Q
+    LirsNode *node;
+} LirsCache;
+
+// Create a LIRS cache with given capacity over the trace's pages
+// 1% of the frames (at least one) hold resident HIR pages
+static LirsCache *create_lirs_cache(const Trace *trace, int capacity)
+{
+    LirsCache *lirs = malloc(sizeof(*lirs));
+    if (!lirs) return NULL;
+
+    lirs->node = calloc(trace->universe > 0 ? trace->universe : 1, sizeof(LirsNode));
+    if (!lirs->node)
+    {
+        free(lirs);
+        return NULL;
+    }
+
+    int hir = (capacity / 100 > 1) ? capacity / 100 : 1;
+    lirs->capacity = capacity;
+    lirs->lir_limit = (capacity - hir > 1) ? capacity - hir : 1;
+    lirs->lir = 0;
+    lirs->resident = 0;
+    lirs->top = -1;
+    lirs->bottom = -1;
+    lirs->front = -1;
+    lirs->back = -1;
+    return lirs;
+}
+
+// Free LIRS cache memory
+static void free_lirs_cache(LirsCache *lirs)
+{
+    if (!lirs) return;
+    free(lirs->node);
+    free(lirs);
+}
+
+// Take a page off S
+static void lirs_stack_unlink(LirsCache *lirs, int page)
+{
+    LirsNode *n = &lirs->node[page];
+
+    if (n->stack_prev != -1)
+        lirs->node[n->stack_prev].stack_next = n->stack_next;
+    else
+        lirs->top = n->stack_next;
+    if (n->stack_next != -1)
+        lirs->node[n->stack_next].stack_prev = n->stack_prev;
+    else
+        lirs->bottom = n->stack_prev;
+    n->flags &= ~LIRS_STACK;
+}
+
+// Put a page on top of S, taking it from its old position if needed
+static void lirs_stack_push(LirsCache *lirs, int page)
+{
+    LirsNode *n = &lirs->node[page];
+
+    if (n->flags & LIRS_STACK)
+    {
+        if (lirs->top == page)
+            return;
+        lirs_stack_unlink(lirs, page);
+    }
+
+    n->stack_prev = -1;
+    n->stack_next = lirs->top;
+    if (lirs->top != -1)
+        lirs->node[lirs->top].stack_prev = page;
+    else
+        lirs->bottom = page;
+    lirs->top = page;
+    n->flags |= LIRS_STACK;
+}
+
+// Take a page off Q
+static void lirs_queue_unlink(LirsCache *lirs, int page)
+{
+    LirsNode *n = &lirs->node[page];
+
+    if (n->queue_prev != -1)
+        lirs->node[n->queue_prev].queue_next = n->queue_next;
+    else
+        lirs->front = n->queue_next;
+    if (n->queue_next != -1)
+        lirs->node[n->queue_next].queue_prev = n->queue_prev;
+    else
+        lirs->back = n->queue_prev;
+    n->flags &= ~LIRS_QUEUE;
+}
+
+// Put a page at the end of Q
+static void lirs_queue_push(LirsCache *lirs, int page)
+{
+    LirsNode *n = &lirs->node[page];
+
+    n->queue_prev = lirs->back;
+    n->queue_next = -1;
+    if (lirs->back != -1)
+        lirs->node[lirs->back].queue_next = page;
+    else
+        lirs->front = page;
+    lirs->back = page;
+    n->flags |= LIRS_QUEUE;
+}
+
+// Stack pruning: drop HIR entries from the bottom of S until a LIR page is
+// at the bottom (non-resident ones are forgotten)
+static void lirs_prune(LirsCache *lirs)
+{
+    while (lirs->bottom != -1 && !(lirs->node[lirs->bottom].flags & LIRS_LIR))
+        lirs_stack_unlink(lirs, lirs->bottom);
+}
+
+// Turn the LIR page at the bottom of S into a resident HIR page on Q
+static void lirs_demote_bottom(LirsCache *lirs)
+{
+    int page = lirs->bottom;
+
+    lirs->node[page].flags &= ~LIRS_LIR;
+    lirs->lir--;
+    lirs_stack_unlink(lirs, page);
+    lirs_queue_push(lirs, page);
+    lirs_prune(lirs);
+}
+
+// Make a page LIR, demoting bottom LIR pages while over the limit
+static void lirs_promote(LirsCache *lirs, int page)
+{
+    lirs->node[page].flags |= LIRS_LIR;
+    lirs->lir++;
+    lirs_stack_push(lirs, page);
+    while (lirs->lir > lirs->lir_limit)
+        lirs_demote_bottom(lirs);
+}
+
+// Run LIRS with f frames over the whole trace, reporting evictions to pipe
+// (NULL for none)
+// Returns 0 on success, -1 on allocation failure
+static int run_lirs(const Trace *trace, int f, int *page_faults, int *write_backs, FlushPipe *pipe)
+{
+    LirsCache *lirs = create_lirs_cache(trace, f);
+    if (!lirs) return -1;
+
+    *page_faults = 0;
+    *write_backs = 0;
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        int pg = trace->pages[i].page;
+        int d = trace->pages[i].dirty;
+        LirsNode *n = &lirs->node[pg];
+
+        if (n->flags & LIRS_RESIDENT)
+        {
+            // Page hit - mark as dirty if current reference is dirty
+            if (d == 1)
+                n->flags |= LIRS_DIRTY;
+
+            if (n->flags & LIRS_LIR)
+            {
+                int was_bottom = (lirs->bottom == pg);
+                lirs_stack_push(lirs, pg);
+                if (was_bottom)
+                    lirs_prune(lirs);
+            }
+            else if (n->flags & LIRS_STACK)
+            {
+                // HIR page with a small reuse distance becomes LIR
+                lirs_queue_unlink(lirs, pg);
+                lirs_promote(lirs, pg);
+            }
+            else
+            {
+                lirs_stack_push(lirs, pg);
+                lirs_queue_unlink(lirs, pg);
+                lirs_queue_push(lirs, pg);
+            }
+            continue;
+        }
+
+        // Page fault
+        (*page_faults)++;
+
+        if (lirs->resident == f)
+        {
+            // Evict the front of Q; with no resident HIR page (one frame),
+            // the bottom LIR page is demoted first
+            if (lirs->front == -1)
+                lirs_demote_bottom(lirs);
+
+            int victim = lirs->front;
+            LirsNode *v = &lirs->node[victim];
+            if (v->flags & LIRS_DIRTY)
+                (*write_backs)++;
+            if (pipe)
+                flush_evict(pipe, i, victim);
+            lirs_queue_unlink(lirs, victim);
+            v->flags &= ~(LIRS_RESIDENT | LIRS_DIRTY);
+            lirs->resident--;
+        }
+
+        n->flags |= LIRS_RESIDENT | (d == 1 ? LIRS_DIRTY : 0);
+        lirs->resident++;
+
+        if (lirs->lir < lirs->lir_limit || (n->flags & LIRS_STACK))
+            lirs_promote(lirs, pg);  // Warming up, or reused while on S
+        else
+        {
+            lirs_stack_push(lirs, pg);
+            lirs_queue_push(lirs, pg);
+        }
+    }
+
+    free_lirs_cache(lirs);
+    return 0;
+}
+
+//  ARC Algorithm Functions 
+
+// ARC list a page is on: resident (T1 recent, T2 frequent) or ghost
+// (B1, B2: recently evicted from T1, T2)
+enum { ARC_NONE, ARC_T1, ARC_T2, ARC_B1, ARC_B2, ARC_LISTS };
+
+// Ring entries (or trace references) between a node's prefetch and its use
+#define ARC_PREFETCH_DISTANCE 8
+
+// Ring entry left behind by a page that moved
+#define ARC_STALE -1
+
+// T1 then B1 (or T2 then B2) as one ring of pages in the order they entered
+// T1 (T2). ARC only ever adds a page at the most recent end, and a resident
+// page only becomes a ghost from the least recent end, so the ghosts are
+// always the oldest part of the ring: entries from tail to split are
+// ghosts, entries from split to head resident. A page that leaves its
+// entry marks it ARC_STALE, and the scans skip those. Positions only grow;
+// entry[pos & mask] holds position pos.
+typedef struct
+{
+    int *entry;    // Page at each position, ARC_STALE once it moved
+    int mask;      // Ring length - 1 (a power of two)
+    int head;      // Next position to fill
+    int split;     // Oldest position that may hold a resident page
+    int tail;      // Oldest position that may hold a ghost
+    int resident;  // Pages on T1 (T2)
+    int ghosts;    // Pages on B1 (B2)
+} ArcRing;
+
+// Per-page ARC state
+// A page's list follows from where its entry lies in its ring, so a ghost
+// leaving the tail needs no write to its node
+typedef struct
+{
+    int pos;              // Position of the page's entry
+    unsigned char ring;   // 0 for none, 1 for T1/B1, 2 for T2/B2
+    unsigned char dirty;  // Dirty bit while resident
+} ArcNode;
+
+// ARC state for one cache size
+typedef struct
+{
+    int capacity;      // c, the number of frames
+    int target;        // p, the adaptive target size of T1
+    ArcRing rings[3];  // Unused, T1 then B1, T2 then B2
+    ArcNode *node;     // Page-indexed
+    FlushPipe *pipe;   // Told of each eviction, NULL for none
+    int now;           // Reference being served (for the pipeline)
+} ArcCache;
+
+// Prepare a ring for up to `live` pages at once; twice that length means a
+// full ring is at least half stale, so compacting it is amortized O(1)
+static int init_arc_ring(ArcRing *ring, long long live)
+{
+    long long length = 2;
+    while (length < 2 * live)
+        length *= 2;
+    if (length > INT_MAX / 2 + 1)
+        return -1;
+
+    ring->entry = malloc(sizeof(int) * (size_t)length);
+    if (!ring->entry) return -1;
+
+    ring->mask = (int)(length - 1);
+    ring->head = 0;
+    ring->split = 0;
+    ring->tail = 0;
+    ring->resident = 0;
+    ring->ghosts = 0;
+    return 0;
+}
+
+// Create an ARC cache with given capacity over the trace's pages
+static ArcCache *create_arc_cache(const Trace *trace, int capacity)
+{
+    ArcCache *arc = malloc(sizeof(*arc));
+    if (!arc) return NULL;
+
+    // T1 + B1 never exceeds c pages and all four lists 2c, and no list
+    // holds more pages than the trace has
+    long long universe = trace->universe > 0 ? trace->universe : 1;
+    long long recent_live = (capacity < universe) ? capacity : universe;
+    long long frequent_live = (2LL * capacity < universe) ? 2LL * capacity : universe;
+
+    arc->node = calloc((size_t)universe, sizeof(ArcNode));
+    arc->rings[0] = (ArcRing){ 0 };
+    arc->rings[1].entry = NULL;
+    arc->rings[2].entry = NULL;
+    if (!arc->node
+        || init_arc_ring(&arc->rings[1], recent_live) != 0
+        || init_arc_ring(&arc->rings[2], frequent_live) != 0)
+    {
+        free(arc->node);
+        free(arc->rings[1].entry);
+        free(arc->rings[2].entry);
+        free(arc);
+        return NULL;
+    }
+
+    arc->capacity = capacity;
+    arc->target = 0;
+    arc->pipe = NULL;
+    arc->now = 0;
+    return arc;
+}
+
+// Free ARC cache memory
+static void free_arc_cache(ArcCache *arc)
+{
+    if (!arc) return;
+    free(arc->node);
+    free(arc->rings[1].entry);
+    free(arc->rings[2].entry);
+    free(arc);
+}
+
+// ARC_* list a page is on
+static int arc_where(const ArcCache *arc, int pg)
+{
+    const ArcNode *node = &arc->node[pg];
+    const ArcRing *ring = &arc->rings[node->ring];
+
+    if (node->ring == 0 || node->pos < ring->tail)
+        return ARC_NONE;
+    if (node->pos >= ring->split)
+        return (node->ring == 1) ? ARC_T1 : ARC_T2;
+    return (node->ring == 1) ? ARC_B1 : ARC_B2;
+}
+
+// Advance pos past stale entries, fetching the nodes of the entries
+// ahead, and return the first live position
+static int arc_skip_stale(const ArcCache *arc, const ArcRing *ring, int pos)
+{
+    while (1)
+    {
+        if (ring->head - pos > ARC_PREFETCH_DISTANCE)
+        {
+            int ahead = ring->entry[(pos + ARC_PREFETCH_DISTANCE) & ring->mask];
+            if (ahead != ARC_STALE)
+                __builtin_prefetch(&arc->node[ahead], 1);
+        }
+        if (ring->entry[pos & ring->mask] != ARC_STALE)
+            return pos;
+        pos++;
+    }
+}
+
+// Drop the stale entries of a full ring, keeping the live ones in order
+static void arc_compact(ArcCache *arc, ArcRing *ring)
+{
+    int to = ring->tail;
+    int split = -1;
+
+    for (int pos = ring->tail; pos < ring->head; pos++)
+    {
+        int pg = ring->entry[pos & ring->mask];
+        if (pos == ring->split)
+            split = to;
+        if (pg == ARC_STALE)
+            continue;
+
+        ring->entry[to & ring->mask] = pg;
+        arc->node[pg].pos = to;
+        to++;
+    }
+    ring->split = (split != -1) ? split : to;
+    ring->head = to;
+}
+
+// Take a page off the list `where` it is on, leaving its entry stale
+static void arc_remove(ArcCache *arc, int pg, int where)
+{
+    ArcNode *node = &arc->node[pg];
+    ArcRing *ring = &arc->rings[node->ring];
+
+    ring->entry[node->pos & ring->mask] = ARC_STALE;
+    if (where == ARC_T1 || where == ARC_T2)
+        ring->resident--;
+    else
+        ring->ghosts--;
+    node->ring = 0;
+}
+
+// Put a page at the most recently used end of T1 (ring 1) or T2 (ring 2)
+static void arc_push(ArcCache *arc, int r, int pg)
+{
+    ArcRing *ring = &arc->rings[r];
+    if (ring->head - ring->tail > ring->mask)
+        arc_compact(arc, ring);
+
+    ring->entry[ring->head & ring->mask] = pg;
+    arc->node[pg].pos = ring->head;
+    arc->node[pg].ring = (unsigned char)r;
+    ring->head++;
+    ring->resident++;
+}
+
+// Count a resident page's eviction: a write-back if it was dirty, and the
+// pipeline's notice
+static void arc_evict(ArcCache *arc, int pg, int *write_backs)
+{
+    *write_backs += arc->node[pg].dirty;
+    if (arc->pipe)
+        flush_evict(arc->pipe, arc->now, pg);
+}
+
+// Take the least recently used page off a ring: its LRU ghost, or with no
+// ghosts its LRU resident page, which is evicted
+static void arc_drop(ArcCache *arc, int r, int *write_backs)
+{
+    ArcRing *ring = &arc->rings[r];
+    int pos = ring->tail;
+
+    // A ghost leaving needs nothing from its node, so nothing to fetch
+    while (ring->entry[pos & ring->mask] == ARC_STALE)
+        pos++;
+
+    ring->tail = pos + 1;
+    if (pos < ring->split)
+    {
+        ring->ghosts--;
+        return;
+    }
+
+    arc_evict(arc, ring->entry[pos & ring->mask], write_backs);
+    ring->split = ring->tail;
+    ring->resident--;
+}
+
+// Turn the least recently used resident page of a ring into its most
+// recent ghost, evicting it
+static void arc_demote(ArcCache *arc, int r, int *write_backs)
+{
+    ArcRing *ring = &arc->rings[r];
+    int pos = arc_skip_stale(arc, ring, ring->split);
+
+    arc_evict(arc, ring->entry[pos & ring->mask], write_backs);
+    ring->split = pos + 1;
+    ring->resident--;
+    ring->ghosts++;
+}
+
+// The steady state of a miss with T1 + B1 full and T1 above target: B1's
+// oldest ghost goes, T1's LRU page becomes its newest ghost and the page
+// joins T1. No list changes size, and the ghost leaving frees the ring
+// entry the page takes
+static void arc_rotate(ArcCache *arc, int pg, int *write_backs)
+{
+    ArcRing *ring = &arc->rings[1];
+    int pos = ring->tail;
+
+    while (ring->entry[pos & ring->mask] == ARC_STALE)
+        pos++;
+    ring->tail = pos + 1;
+
+    pos = arc_skip_stale(arc, ring, ring->split);
+    arc_evict(arc, ring->entry[pos & ring->mask], write_backs);
+    ring->split = pos + 1;
+
+    ring->entry[ring->head & ring->mask] = pg;
+    arc->node[pg].pos = ring->head++;
+    arc->node[pg].ring = 1;
+}
+
+// Move a T2 page to T2's most recently used end
+static void arc_renew(ArcCache *arc, int pg)
+{
+    ArcRing *ring = &arc->rings[2];
+    ArcNode *node = &arc->node[pg];
+
+    if (ring->head - ring->tail > ring->mask)
+        arc_compact(arc, ring);
+    ring->entry[node->pos & ring->mask] = ARC_STALE;
+    ring->entry[ring->head & ring->mask] = pg;
+    node->pos = ring->head++;
+}
+
+// ARC REPLACE: evict from T1 when it is above target (or at target and the
+// missed page is a B2 ghost), otherwise from T2
+static void arc_replace(ArcCache *arc, int in_b2, int *write_backs)
+{
+    int t1 = arc->rings[1].resident;
+
+    if (t1 > 0 && (t1 > arc->target || (in_b2 && t1 == arc->target)))
+        arc_demote(arc, 1, write_backs);
+    else
+        arc_demote(arc, 2, write_backs);
+}
+
+// Run ARC with f frames over the whole trace, reporting evictions to pipe
+// (NULL for none)
+// Returns 0 on success, -1 on allocation failure
+static int run_arc(const Trace *trace, int f, int *page_faults, int *write_backs, FlushPipe *pipe)
+{
+    ArcCache *arc = create_arc_cache(trace, f);
+    if (!arc) return -1;
+
+    ArcRing *recent = &arc->rings[1];
+    ArcRing *frequent = &arc->rings[2];
+    int faults = 0;
+    int written = 0;
+    arc->pipe = pipe;
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        int pg = trace->pages[i].page;
+        int d = trace->pages[i].dirty;
+        int where = arc_where(arc, pg);
+
+        // Nodes are scattered over the universe: fetch ahead of use
+        if (trace->count - i > ARC_PREFETCH_DISTANCE)
+            __builtin_prefetch(&arc->node[trace->pages[i + ARC_PREFETCH_DISTANCE].page], 1);
+
+        if (where == ARC_T1 || where == ARC_T2)
+        {
+            // Page hit - mark as dirty if current reference is dirty and
+            // move the page to the front of the frequent list
+            arc->node[pg].dirty |= (unsigned char)(d == 1);
+            if (where == ARC_T1)
+            {
+                arc_remove(arc, pg, where);
+                arc_push(arc, 2, pg);
+            }
+            else if (arc->node[pg].pos != frequent->head - 1)
+                arc_renew(arc, pg);
+            continue;
+        }
+
+        // Page fault
+        faults++;
+        arc->now = i;
+
+        if (where == ARC_B1)
+        {
+            // Recency ghost hit: grow the T1 target
+            int delta = (frequent->ghosts > recent->ghosts) ? frequent->ghosts / recent->ghosts : 1;
+            arc->target = (arc->target + delta < f) ? arc->target + delta : f;
+            arc_replace(arc, 0, &written);
+            arc_remove(arc, pg, where);
+            arc_push(arc, 2, pg);
+        }
+        else if (where == ARC_B2)
+        {
+            // Frequency ghost hit: shrink the T1 target
+            int delta = (recent->ghosts > frequent->ghosts) ? recent->ghosts / frequent->ghosts : 1;
+            arc->target = (arc->target - delta > 0) ? arc->target - delta : 0;
+            arc_replace(arc, 1, &written);
+            arc_remove(arc, pg, where);
+            arc_push(arc, 2, pg);
+        }
+        else
+        {
+            int l1 = recent->resident + recent->ghosts;
+            int total = l1 + frequent->resident + frequent->ghosts;
+
+            if (l1 == f && recent->ghosts > 0 && recent->resident > arc->target)
+                arc_rotate(arc, pg, &written);
+            else
+            {
+                if (l1 == f)
+                {
+                    // With no B1 ghosts this evicts T1's LRU page, which
+                    // fills the cache, without leaving a ghost
+                    int full = (recent->ghosts == 0);
+                    arc_drop(arc, 1, &written);
+                    if (!full)
+                        arc_replace(arc, 0, &written);
+                }
+                else if (total >= f)
+                {
+                    if (total == 2 * f)
+                        arc_drop(arc, 2, &written);
+                    arc_replace(arc, 0, &written);
+                }
+                arc_push(arc, 1, pg);
+            }
+        }
+        arc->node[pg].dirty = (unsigned char)(d == 1);
+    }
+
+    *page_faults = faults;
+    *write_backs = written;
+    free_arc_cache(arc);
+    return 0;
+}
+
+//  Reference Implementations 
+
+// Straightforward engines with the original per-reference loops: linear
+// frame scans, OPT victims found by scanning the trace forward, and every
+// CLK register shifted eagerly. They are slow but easy to check by eye,
+// and VERIFY (or --reference) compares the fast engines against them.
+
+// Reference FIFO: circular queue searched linearly on every reference
+static int reference_fifo(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        Page *arr = malloc(sizeof(Page) * f);
+        if (!arr) return -1;
+
+        int front = 0;
+        int size = 0;
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int j = 0; j < trace->count; j++)
+        {
+            Page current = trace->pages[j];
+            int idx = -1;
+
+            for (int i = 0; i < size; i++)
+            {
+                int k = (front + i) % f;
+                if (arr[k].page == current.page)
+                {
+                    idx = k;
+                    break;
+                }
+            }
+
+            if (idx == -1)
+            {
+                rows[r].page_faults++;
+
+                // If frames are full, evict the oldest page
+                if (size == f)
+                {
+                    if (arr[front].dirty == 1)
+                        rows[r].write_backs++;
+                    front = (front + 1) % f;
+                    size--;
+                }
+                arr[(front + size) % f] = current;
+                size++;
+            }
+            else if (current.dirty == 1)
+                arr[idx].dirty = 1;
+        }
+        free(arr);
+    }
+    return 0;
+}
+
+// Reference helper for OPT: next use of a page after curr_index, found by
+// scanning forward, or INT_MAX if the page is never used again
+static int find_next_use(const Trace *trace, int curr_index, int page)
+{
+    for (int i = curr_index + 1; i < trace->count; i++)
+    {
+        if (trace->pages[i].page == page)
+            return i;
+    }
+    return INT_MAX;
+}
+
+// Reference OPT: farthest next use evicted, oldest insertion breaks ties
+static int reference_opt(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        int *frame_pages = malloc(sizeof(int) * f);
+        int *frame_dirty = malloc(sizeof(int) * f);
+        int *frame_order = malloc(sizeof(int) * f);  // For FIFO tie-breaking
+        if (!frame_pages || !frame_dirty || !frame_order)
+        {
+            free(frame_pages);
+            free(frame_dirty);
+            free(frame_order);
+            return -1;
+        }
+
+        int used = 0;
+        int timestamp = 0;
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            int pg = trace->pages[i].page;
+            int d = trace->pages[i].dirty;
+            int hit = -1;
+
+            for (int x = 0; x < used; x++)
+            {
+                if (frame_pages[x] == pg)
+                {
+                    hit = x;
+                    break;
+                }
+            }
+
+            if (hit != -1)
+            {
+                if (d == 1)
+                    frame_dirty[hit] = 1;
+                continue;
+            }
+
+            rows[r].page_faults++;
+            if (used < f)
+            {
+                frame_pages[used] = pg;
+                frame_dirty[used] = d;
+                frame_order[used] = timestamp++;
+                used++;
+                continue;
+            }
+
+            int victim = 0;
+            int farthest = -1;
+            int oldest_order = INT_MAX;
+            for (int x = 0; x < f; x++)
+            {
+                int next = find_next_use(trace, i, frame_pages[x]);
+                if (next > farthest || (next == farthest && frame_order[x] < oldest_order))
+                {
+                    farthest = next;
+                    victim = x;
+                    oldest_order = frame_order[x];
+                }
+            }
+
+            if (frame_dirty[victim] == 1)
+                rows[r].write_backs++;
+            frame_pages[victim] = pg;
+            frame_dirty[victim] = d;
+            frame_order[victim] = timestamp++;
+        }
+
+        free(frame_pages);
+        free(frame_dirty);
+        free(frame_order);
+    }
+    return 0;
+}
+
+// Reference LRU: frames stamped with their last use, least recent evicted
+static int reference_lru(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        Page *frame = malloc(sizeof(Page) * f);
+        int *last_used = malloc(sizeof(int) * f);
+        if (!frame || !last_used)
+        {
+            free(frame);
+            free(last_used);
+            return -1;
+        }
+
+        int used = 0;
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            Page current = trace->pages[i];
+            int slot = -1;
+
+            for (int x = 0; x < used; x++)
+            {
+                if (frame[x].page == current.page)
+                {
+                    slot = x;
+                    break;
+                }
+            }
+
+            if (slot != -1)
+            {
+                if (current.dirty == 1)
+                    frame[slot].dirty = 1;
+            }
+            else
+            {
+                rows[r].page_faults++;
+                if (used < f)
+                    slot = used++;
+                else
+                {
+                    slot = 0;
+                    for (int x = 1; x < f; x++)
+                    {
+                        if (last_used[x] < last_used[slot])
+                            slot = x;
+                    }
+                    if (frame[slot].dirty == 1)
+                        rows[r].write_backs++;
+                }
+                frame[slot] = current;
+            }
+            last_used[slot] = i;
+        }
+
+        free(frame);
+        free(last_used);
+    }
+    return 0;
+}
+
+// Reference Second Chance: linear frame search and every register shifted
+// as soon as m references have passed
+static int reference_clock(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        int n = rows[r].n;
+        unsigned int n_bit_mask = reference_mask(n);
+        ClockPage *frame = malloc(sizeof(ClockPage) * f);
+        if (!frame) return -1;
+
+        int size = 0;
+        int hand = 0;
+        int ref_counter = 0;
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            int current_page = trace->pages[i].page;
+            int current_dirty = trace->pages[i].dirty;
+            int page_index = -1;
+
+            for (int x = 0; x < size; x++)
+            {
+                if (frame[x].page == current_page)
+                {
+                    page_index = x;
+                    break;
+                }
+            }
+
+            if (page_index != -1)
+            {
+                // Page hit - set reference bit and update dirty flag
+                frame[page_index].ref_bits |= 1U << (n - 1);
+                if (current_dirty == 1)
+                    frame[page_index].dirty = 1;
+            }
+            else
+            {
+                rows[r].page_faults++;
+                int victim = size;
+
+                if (size < f)
+                    size++;
+                else
+                {
+                    // Sweep until a register is all zeros, halving the others
+                    int start_hand = hand;
+                    while (1)
+                    {
+                        if ((frame[hand].ref_bits & n_bit_mask) == 0)
+                        {
+                            victim = hand;
+                            hand = (hand + 1) % size;
+                            break;
+                        }
+                        frame[hand].ref_bits >>= 1;
+                        hand = (hand + 1) % size;
+                        if (hand == start_hand)
+                        {
+                            victim = hand;
+                            hand = (hand + 1) % size;
+                            break;
+                        }
+                    }
+                    if (frame[victim].dirty == 1)
+                        rows[r].write_backs++;
+                }
+
+                frame[victim].page = current_page;
+                frame[victim].dirty = current_dirty;
+                frame[victim].ref_bits = 1U << (n - 1);
+            }
+
+            // Shift reference bits after m references
+            if (++ref_counter >= rows[r].m)
+            {
+                for (int x = 0; x < size; x++)
+                    frame[x].ref_bits >>= 1;
+                ref_counter = 0;
+            }
+        }
+        free(frame);
+    }
+    return 0;
+}
+
+// Reference helper: position of a page in an array, or -1
+static int reference_find(const int *list, int size, int page)
+{
+    for (int x = 0; x < size; x++)
+    {
+        if (list[x] == page)
+            return x;
+    }
+    return -1;
+}
+
+// Reference CLOCK-Pro ring: entries kept in clockwise order in arrays,
+// hands are indices, and every insert or removal shifts the arrays
+typedef struct
+{
+    int *page;
+    unsigned char *flags;  // CP_* bits
+    int size;
+    int hand[3];  // HAND_hot, HAND_cold, HAND_test
+    int m, cold_target, cold_min, cold_max;
+    int hot, resident, non_resident;
+} ReferenceRing;
+
+enum { REF_HAND_HOT, REF_HAND_COLD, REF_HAND_TEST };
+
+// Remove ring[at]; a hand on it moves to the next entry
+static void reference_ring_remove(ReferenceRing *rr, int at)
+{
+    memmove(&rr->page[at], &rr->page[at + 1], sizeof(int) * (rr->size - at - 1));
+    memmove(&rr->flags[at], &rr->flags[at + 1], rr->size - at - 1);
+    rr->size--;
+    for (int h = 0; h < 3; h++)
+    {
+        if (rr->hand[h] > at)
+            rr->hand[h]--;
+        if (rr->hand[h] >= rr->size)
+            rr->hand[h] = 0;
+    }
+}
+
+// Insert an entry just behind HAND_hot
+static void reference_ring_insert(ReferenceRing *rr, int page, unsigned char flags)
+{
+    int at = (rr->size == 0) ? 0 : rr->hand[REF_HAND_HOT];
+
+    memmove(&rr->page[at + 1], &rr->page[at], sizeof(int) * (rr->size - at));
+    memmove(&rr->flags[at + 1], &rr->flags[at], rr->size - at);
+    rr->page[at] = page;
+    rr->flags[at] = flags;
+    rr->size++;
+    for (int h = 0; h < 3; h++)
+    {
+        if (rr->size == 1)
+            rr->hand[h] = 0;
+        else if (rr->hand[h] >= at)
+            rr->hand[h]++;
+    }
+}
+
+// Move ring[at] to the list head
+static void reference_ring_move_head(ReferenceRing *rr, int at)
+{
+    int page = rr->page[at];
+    unsigned char flags = rr->flags[at];
+
+    reference_ring_remove(rr, at);
+    reference_ring_insert(rr, page, flags);
+}
+
+// Reference helper: clamp the cold target after a change of delta
+static void reference_adapt(ReferenceRing *rr, int delta)
+{
+    rr->cold_target += delta;
+    if (rr->cold_target < rr->cold_min) rr->cold_target = rr->cold_min;
+    if (rr->cold_target > rr->cold_max) rr->cold_target = rr->cold_max;
+}
+
+// Reference helper: end the test period of ring[at]
+// Returns 1 if the entry was removed
+static int reference_end_test(ReferenceRing *rr, int at)
+{
+    rr->flags[at] &= ~CP_TEST;
+    reference_adapt(rr, -1);
+    if (rr->flags[at] & CP_RESIDENT)
+        return 0;
+    rr->non_resident--;
+    reference_ring_remove(rr, at);
+    return 1;
+}
+
+// Reference HAND_hot
+static void reference_hand_hot(ReferenceRing *rr)
+{
+    while (rr->hot > rr->m - rr->cold_target)
+    {
+        int at = rr->hand[REF_HAND_HOT];
+
+        if (rr->flags[at] & CP_HOT)
+        {
+            if (rr->flags[at] & CP_REF)
+                rr->flags[at] &= ~CP_REF;
+            else
+            {
+                rr->flags[at] &= ~CP_HOT;
+                rr->hot--;
+            }
+        }
+        else if ((rr->flags[at] & CP_TEST) && reference_end_test(rr, at))
+            continue;
+        rr->hand[REF_HAND_HOT] = (at + 1) % rr->size;
+    }
+}
+
+// Reference HAND_test
+static void reference_hand_test(ReferenceRing *rr)
+{
+    while (rr->non_resident > rr->m)
+    {
+        int at = rr->hand[REF_HAND_TEST];
+
+        if ((rr->flags[at] & CP_TEST) && reference_end_test(rr, at))
+            continue;
+        rr->hand[REF_HAND_TEST] = (at + 1) % rr->size;
+    }
+}
+
+// Reference HAND_cold
+static void reference_hand_cold(ReferenceRing *rr, int *write_backs)
+{
+    for (;;)
+    {
+        int at = rr->hand[REF_HAND_COLD];
+        unsigned char fl = rr->flags[at];
+
+        if ((fl & CP_HOT) || !(fl & CP_RESIDENT))
+        {
+            rr->hand[REF_HAND_COLD] = (at + 1) % rr->size;
+            continue;
+        }
+
+        if (fl & CP_REF)
+        {
+            if (fl & CP_TEST)
+            {
+                rr->flags[at] = (fl & ~(CP_REF | CP_TEST)) | CP_HOT;
+                rr->hot++;
+                reference_adapt(rr, 1);
+                reference_ring_move_head(rr, at);
+                reference_hand_hot(rr);
+            }
+            else
+            {
+                rr->flags[at] = (fl & ~CP_REF) | CP_TEST;
+                reference_ring_move_head(rr, at);
+            }
+            continue;
+        }
+
+        if (fl & CP_DIRTY)
+            (*write_backs)++;
+        rr->flags[at] = fl & ~(CP_RESIDENT | CP_DIRTY);
+        rr->resident--;
+        rr->hand[REF_HAND_COLD] = (at + 1) % rr->size;
+        if (fl & CP_TEST)
+            rr->non_resident++;
+        else
+            reference_ring_remove(rr, at);
+        return;
+    }
+}
+
+// Reference CLOCK-Pro: ring entries found by linear search
+static int reference_clockpro(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        ReferenceRing rr;
+
+        rr.page = malloc(sizeof(int) * (2 * f + 1));
+        rr.flags = malloc(2 * f + 1);
+        if (!rr.page || !rr.flags)
+        {
+            free(rr.page);
+            free(rr.flags);
+            return -1;
+        }
+        rr.size = 0;
+        rr.hand[0] = rr.hand[1] = rr.hand[2] = 0;
+        rr.m = f;
+        rr.cold_min = (f / CP_COLD_MIN_DIV > 1) ? f / CP_COLD_MIN_DIV : 1;
+        rr.cold_max = (f - 1 > rr.cold_min) ? f - 1 : rr.cold_min;
+        rr.cold_target = rr.cold_min;
+        rr.hot = 0;
+        rr.resident = 0;
+        rr.non_resident = 0;
+
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            Page current = trace->pages[i];
+            int at = reference_find(rr.page, rr.size, current.page);
+
+            if (at != -1 && (rr.flags[at] & CP_RESIDENT))
+            {
+                rr.flags[at] |= CP_REF | (current.dirty == 1 ? CP_DIRTY : 0);
+                continue;
+            }
+
+            rows[r].page_faults++;
+            int warming = (rr.resident < f);
+            if (!warming)
+                reference_hand_cold(&rr, &rows[r].write_backs);
+
+            unsigned char fl = (current.dirty == 1) ? CP_RESIDENT | CP_DIRTY : CP_RESIDENT;
+            at = reference_find(rr.page, rr.size, current.page);
+            if (at != -1)
+            {
+                rr.flags[at] = fl | CP_HOT;
+                rr.non_resident--;
+                rr.hot++;
+                reference_adapt(&rr, 1);
+                reference_ring_move_head(&rr, at);
+            }
+            else if (warming && rr.hot < f - rr.cold_target)
+            {
+                rr.hot++;
+                reference_ring_insert(&rr, current.page, fl | CP_HOT);
+            }
+            else
+                reference_ring_insert(&rr, current.page, fl | CP_TEST);
+            rr.resident++;
+
+            reference_hand_hot(&rr);
+            reference_hand_test(&rr);
+        }
+
+        free(rr.page);
+        free(rr.flags);
+    }
+    return 0;
+}
+
+// Reference helper: remove list[at]
+static void reference_remove(int *list, int *size, int at)
+{
+    memmove(&list[at], &list[at + 1], sizeof(int) * (*size - at - 1));
+    (*size)--;
+}
+
+// Reference helper: LIRS stack pruning and bottom demotion on arrays
+// (stack[0] is the bottom of S, queue[0] the front of Q)
+static void reference_lirs_demote(int *stack, int *stack_size, int *queue, int *queue_size,
+                                  unsigned char *flags, int *lir)
+{
+    flags[stack[0]] &= ~LIRS_LIR;
+    (*lir)--;
+    queue[(*queue_size)++] = stack[0];
+    reference_remove(stack, stack_size, 0);
+    while (*stack_size > 0 && !(flags[stack[0]] & LIRS_LIR))
+        reference_remove(stack, stack_size, 0);
+}
+
+// Reference LIRS: S and Q as arrays searched linearly
+static int reference_lirs(const Trace *trace, SimRow *rows, int count)
+{
+    size_t universe = trace->universe > 0 ? trace->universe : 1;
+
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        int hir = (f / 100 > 1) ? f / 100 : 1;
+        int lir_limit = (f - hir > 1) ? f - hir : 1;
+        int *stack = malloc(sizeof(int) * universe);
+        int *queue = malloc(sizeof(int) * (f + 1));
+        unsigned char *flags = calloc(universe, 1);  // LIRS_LIR, _RESIDENT, _DIRTY
+        int stack_size = 0, queue_size = 0, lir = 0, resident = 0;
+
+        if (!stack || !queue || !flags)
+        {
+            free(stack);
+            free(queue);
+            free(flags);
+            return -1;
+        }
+
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            Page current = trace->pages[i];
+            int pg = current.page;
+            int s_at = reference_find(stack, stack_size, pg);
+
+            if (flags[pg] & LIRS_RESIDENT)
+            {
+                if (current.dirty == 1)
+                    flags[pg] |= LIRS_DIRTY;
+                if (s_at != -1)
+                    reference_remove(stack, &stack_size, s_at);
+                if (!(flags[pg] & LIRS_LIR))
+                    reference_remove(queue, &queue_size, reference_find(queue, queue_size, pg));
+                stack[stack_size++] = pg;
+
+                if (flags[pg] & LIRS_LIR)
+                {
+                    while (stack_size > 0 && !(flags[stack[0]] & LIRS_LIR))
+                        reference_remove(stack, &stack_size, 0);
+                }
+                else if (s_at != -1)
+                {
+                    flags[pg] |= LIRS_LIR;
+                    lir++;
+                    while (lir > lir_limit)
+                        reference_lirs_demote(stack, &stack_size, queue, &queue_size, flags, &lir);
+                }
+                else
+                    queue[queue_size++] = pg;
+                continue;
+            }
+
+            rows[r].page_faults++;
+            if (resident == f)
+            {
+                if (queue_size == 0)
+                    reference_lirs_demote(stack, &stack_size, queue, &queue_size, flags, &lir);
+                int victim = queue[0];
+                if (flags[victim] & LIRS_DIRTY)
+                    rows[r].write_backs++;
+                flags[victim] &= ~(LIRS_RESIDENT | LIRS_DIRTY);
+                reference_remove(queue, &queue_size, 0);
+                resident--;
+            }
+
+            flags[pg] |= LIRS_RESIDENT | (current.dirty == 1 ? LIRS_DIRTY : 0);
+            resident++;
+
+            s_at = reference_find(stack, stack_size, pg);
+            if (s_at != -1)
+                reference_remove(stack, &stack_size, s_at);
+            stack[stack_size++] = pg;
+            if (lir < lir_limit || s_at != -1)
+            {
+                flags[pg] |= LIRS_LIR;
+                lir++;
+                while (lir > lir_limit)
+                    reference_lirs_demote(stack, &stack_size, queue, &queue_size, flags, &lir);
+            }
+            else
+                queue[queue_size++] = pg;
+        }
+
+        free(stack);
+        free(queue);
+        free(flags);
+    }
+    return 0;
+}
+
+// Reference Enhanced Second Chance: the ring and the candidates kept as
+// arrays of frame indices (ring[0] under the hand), frames found by linear
+// search and every register shifted at each interval
+static int reference_esc(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        int n = rows[r].n;
+        unsigned int n_bit_mask = reference_mask(n);
+        ClockPage *frame = malloc(sizeof(ClockPage) * f);
+        int *list[ESC_LISTS];
+        int size[ESC_LISTS] = { 0 };
+        int failed = !frame;
+
+        for (int l = 0; l < ESC_LISTS; l++)
+        {
+            list[l] = malloc(sizeof(int) * f);
+            failed |= !list[l];
+        }
+        if (failed)
+        {
+            free(frame);
+            for (int l = 0; l < ESC_LISTS; l++)
+                free(list[l]);
+            return -1;
+        }
+
+        int used = 0;
+        int ref_counter = 0;
+        double credit = 0;
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            Page current = trace->pages[i];
+            int x = 0;
+            while (x < used && frame[x].page != current.page)
+                x++;
+
+            if (x < used)
+            {
+                frame[x].ref_bits |= 1U << (n - 1);
+                if (current.dirty == 1)
+                    frame[x].dirty = 1;
+                for (int l = ESC_CLEAN; l < ESC_LISTS; l++)
+                {
+                    int at = reference_find(list[l], size[l], x);
+                    if (at != -1)
+                    {
+                        reference_remove(list[l], &size[l], at);
+                        list[ESC_RING][size[ESC_RING]++] = x;
+                    }
+                }
+            }
+            else
+            {
+                rows[r].page_faults++;
+
+                if (used < f)
+                    x = used++;
+                else
+                {
+                    credit = (credit + rows[r].wb_budget < 1) ? credit + rows[r].wb_budget : 1;
+                    int dirty_ok = (credit >= 1);
+                    int steps = size[ESC_RING];
+
+                    while (size[ESC_CLEAN] == 0 && !(dirty_ok && size[ESC_DIRTY] > 0) && steps-- > 0)
+                    {
+                        int hand = list[ESC_RING][0];
+                        reference_remove(list[ESC_RING], &size[ESC_RING], 0);
+                        if ((frame[hand].ref_bits & n_bit_mask) == 0)
+                        {
+                            int l = (frame[hand].dirty == 1) ? ESC_DIRTY : ESC_CLEAN;
+                            list[l][size[l]++] = hand;
+                        }
+                        else
+                        {
+                            frame[hand].ref_bits >>= 1;
+                            list[ESC_RING][size[ESC_RING]++] = hand;
+                        }
+                    }
+
+                    int l = (size[ESC_CLEAN] > 0) ? ESC_CLEAN : (size[ESC_DIRTY] > 0) ? ESC_DIRTY : ESC_RING;
+                    x = list[l][0];
+                    reference_remove(list[l], &size[l], 0);
+                    if (frame[x].dirty == 1)
+                    {
+                        rows[r].write_backs++;
+                        credit = 0;
+                    }
+                }
+
+                frame[x].page = current.page;
+                frame[x].dirty = current.dirty;
+                frame[x].ref_bits = 1U << (n - 1);
+                list[ESC_RING][size[ESC_RING]++] = x;
+            }
+
+            if (++ref_counter >= rows[r].m)
+            {
+                for (int k = 0; k < used; k++)
+                    frame[k].ref_bits >>= 1;
+                ref_counter = 0;
+            }
+        }
+
+        free(frame);
+        for (int l = 0; l < ESC_LISTS; l++)
+            free(list[l]);
+    }
+    return 0;
+}
+
+// Reference ARC: the four lists kept as arrays ordered from least to most
+// recently used, searched linearly and shifted on every move
+static int reference_arc(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        Page *list[ARC_LISTS];  // list[l][0] is the LRU end
+        int size[ARC_LISTS] = { 0 };
+        int target = 0;
+        int failed = 0;
+
+        for (int l = 0; l < ARC_LISTS; l++)
+        {
+            list[l] = malloc(sizeof(Page) * (2 * f));
+            failed |= !list[l];
+        }
+        if (failed)
+        {
+            for (int l = 0; l < ARC_LISTS; l++)
+                free(list[l]);
+            return -1;
+        }
+
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            Page current = trace->pages[i];
+            int found = ARC_NONE;
+            int pos = -1;
+
+            for (int l = ARC_T1; l < ARC_LISTS && found == ARC_NONE; l++)
+            {
+                for (int x = 0; x < size[l]; x++)
+                {
+                    if (list[l][x].page == current.page)
+                    {
+                        found = l;
+                        pos = x;
+                        break;
+                    }
+                }
+            }
+
+            Page entry = current;
+            if (found != ARC_NONE)
+            {
+                // Take the page out of its list
+                entry = list[found][pos];
+                memmove(&list[found][pos], &list[found][pos + 1], sizeof(Page) * (size[found] - pos - 1));
+                size[found]--;
+            }
+
+            if (found == ARC_T1 || found == ARC_T2)
+            {
+                if (current.dirty == 1)
+                    entry.dirty = 1;
+                list[ARC_T2][size[ARC_T2]++] = entry;
+                continue;
+            }
+
+            rows[r].page_faults++;
+            int replace = 0;
+            int in_b2 = (found == ARC_B2);
+
+            if (found == ARC_B1)
+            {
+                int delta = (size[ARC_B2] > size[ARC_B1] + 1) ? size[ARC_B2] / (size[ARC_B1] + 1) : 1;
+                target = (target + delta < f) ? target + delta : f;
+                replace = 1;
+            }
+            else if (found == ARC_B2)
+            {
+                int delta = (size[ARC_B1] > size[ARC_B2] + 1) ? size[ARC_B1] / (size[ARC_B2] + 1) : 1;
+                target = (target - delta > 0) ? target - delta : 0;
+                replace = 1;
+            }
+            else if (size[ARC_T1] + size[ARC_B1] == f)
+            {
+                if (size[ARC_T1] < f)
+                {
+                    memmove(&list[ARC_B1][0], &list[ARC_B1][1], sizeof(Page) * (size[ARC_B1] - 1));
+                    size[ARC_B1]--;
+                    replace = 1;
+                }
+                else
+                {
+                    if (list[ARC_T1][0].dirty == 1)
+                        rows[r].write_backs++;
+                    memmove(&list[ARC_T1][0], &list[ARC_T1][1], sizeof(Page) * (size[ARC_T1] - 1));
+                    size[ARC_T1]--;
+                }
+            }
+            else if (size[ARC_T1] + size[ARC_T2] + size[ARC_B1] + size[ARC_B2] >= f)
+            {
+                if (size[ARC_T1] + size[ARC_T2] + size[ARC_B1] + size[ARC_B2] == 2 * f)
+                {
+                    memmove(&list[ARC_B2][0], &list[ARC_B2][1], sizeof(Page) * (size[ARC_B2] - 1));
+                    size[ARC_B2]--;
+                }
+                replace = 1;
+            }
+
+            if (replace)
+            {
+                int from = ARC_T2;
+                int to = ARC_B2;
+                if (size[ARC_T1] > 0 && (size[ARC_T1] > target || (in_b2 && size[ARC_T1] == target)))
+                {
+                    from = ARC_T1;
+                    to = ARC_B1;
+                }
+
+                Page victim = list[from][0];
+                memmove(&list[from][0], &list[from][1], sizeof(Page) * (size[from] - 1));
+                size[from]--;
+                if (victim.dirty == 1)
+                    rows[r].write_backs++;
+                victim.dirty = 0;
+                list[to][size[to]++] = victim;
+            }
+
+            entry.dirty = current.dirty;
+            if (found == ARC_NONE)
+                list[ARC_T1][size[ARC_T1]++] = entry;
+            else
+                list[ARC_T2][size[ARC_T2]++] = entry;
+        }
+
+        for (int l = 0; l < ARC_LISTS; l++)
+            free(list[l]);
+    }
+    return 0;
+}
+
+// Reference WS: resident pages in an unordered array, all of them checked
+// for having left the window on every reference
+static int reference_ws(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int tau = rows[r].tau;
+        ClockPage *frame = malloc(sizeof(ClockPage) * (trace->universe > 0 ? trace->universe : 1));
+        if (!frame) return -1;
+
+        int used = 0;
+        double resident = 0;
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            Page current = trace->pages[i];
+
+            for (int x = 0; x < used; )
+            {
+                if (i - frame[x].last_use > tau)
+                {
+                    if (frame[x].dirty == 1)
+                        rows[r].write_backs++;
+                    frame[x] = frame[--used];
+                }
+                else
+                    x++;
+            }
+
+            int x = 0;
+            while (x < used && frame[x].page != current.page)
+                x++;
+            if (x < used)
+            {
+                if (current.dirty == 1)
+                    frame[x].dirty = 1;
+            }
+            else
+            {
+                rows[r].page_faults++;
+                frame[used].page = current.page;
+                frame[used].dirty = current.dirty;
+                used++;
+            }
+            frame[x].last_use = i;
+
+            for (int y = 0; y < used; y++)
+                resident += (i - frame[y].last_use < tau);
+        }
+
+        rows[r].avg_resident = (trace->count > 0) ? resident / trace->count : 0;
+        free(frame);
+    }
+    return 0;
+}
+
+// Reference WSClock: linear frame search, and every frame scanned to see
+// whether any page has left the window before the hand moves
+static int reference_wsclock(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        int f = rows[r].frames;
+        int tau = rows[r].tau;
+        ClockPage *frame = malloc(sizeof(ClockPage) * f);
+        if (!frame) return -1;
+
+        int used = 0;
+        int hand = 0;
+        double resident = 0;
+        rows[r].page_faults = 0;
+        rows[r].write_backs = 0;
+
+        for (int i = 0; i < trace->count; i++)
+        {
+            Page current = trace->pages[i];
+            int x = 0;
+            while (x < used && frame[x].page != current.page)
+                x++;
+
+            if (x < used)
+            {
+                if (current.dirty == 1)
+                    frame[x].dirty = 1;
+            }
+            else
+            {
+                rows[r].page_faults++;
+                if (used < f)
+                    x = used++;
+                else
+                {
+                    int lru = 0, old = 0;
+                    for (int y = 0; y < f; y++)
+                    {
+                        old |= (i - frame[y].last_use > tau);
+                        if (frame[y].last_use < frame[lru].last_use)
+                            lru = y;
+                    }
+
+                    x = lru;
+                    while (old)
+                    {
+                        int at = hand;
+                        hand = (hand + 1) % f;
+                        if (i - frame[at].last_use <= tau)
+                            continue;
+                        if (frame[at].dirty == 0)
+                        {
+                            x = at;
+                            break;
+                        }
+                        rows[r].write_backs++;
+                        frame[at].dirty = 0;
+                    }
+                    if (frame[x].dirty == 1)
+                        rows[r].write_backs++;
+                }
+                frame[x].page = current.page;
+                frame[x].dirty = current.dirty;
+            }
+            frame[x].last_use = i;
+            resident += used;
+        }
+
+        rows[r].avg_resident = (trace->count > 0) ? resident / trace->count : 0;
+        free(frame);
+    }
+    return 0;
+}
+
+//  Worker Pool 
+
+// Monotonic wall-clock time in seconds
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// A unit of work: fills in the counts of rows[0..count-1]
+typedef struct
+{
+    int (*run)(const Trace *trace, SimRow *rows, int count);
+    const Trace *trace;
+    SimRow *rows;
+    int count;
+} SimJob;
+
+// Jobs shared by all workers; each worker claims the next unstarted job,
+// so a slow configuration never holds up work queued behind it
+typedef struct
+{
+    SimJob *jobs;
+    int job_count;
+    atomic_int next;
+    atomic_int failed;
+} JobQueue;
+
+// Worker thread: run jobs until none are left
+static void *job_worker(void *arg)
+{
+    JobQueue *jq = arg;
+    int j;
+
+    while ((j = atomic_fetch_add(&jq->next, 1)) < jq->job_count)
+    {
+        SimJob *job = &jq->jobs[j];
+        double start = now_seconds();
+        if (job->run(job->trace, job->rows, job->count) != 0)
+            atomic_store(&jq->failed, 1);
+
+        // Rows simulated together share the job's time evenly
+        double share = (now_seconds() - start) / (job->count > 0 ? job->count : 1);
+        for (int r = 0; r < job->count; r++)
+            job->rows[r].seconds = share;
+    }
+    return NULL;
+}
+
+// Run all jobs on `threads` threads (the caller's thread included)
+// Jobs are claimed in array order, so list the most expensive ones first
+// Returns 0 on success, -1 if any job or thread could not be started
+static int run_jobs(SimJob *jobs, int job_count, int threads)
+{
+    JobQueue jq;
+    jq.jobs = jobs;
+    jq.job_count = job_count;
+    atomic_init(&jq.next, 0);
+    atomic_init(&jq.failed, 0);
+
+    if (threads > job_count)
+        threads = job_count;
+
+    pthread_t *workers = malloc(sizeof(pthread_t) * (threads > 1 ? threads - 1 : 1));
+    if (!workers) return -1;
+
+    int started = 0;
+    for (int t = 1; t < threads; t++)
+    {
+        if (pthread_create(&workers[started], NULL, job_worker, &jq) != 0)
+            break;  // Carry on with the threads we have
+        started++;
+    }
+
+    job_worker(&jq);
+    for (int t = 0; t < started; t++)
+        pthread_join(workers[t], NULL);
+
+    free(workers);
+    return atomic_load(&jq.failed) ? -1 : 0;
+}
+
+// Job: OPT for each row (requires next_use[])
+static int opt_job(const Trace *trace, SimRow *rows, int count)
+{
+    return run_each_row(trace, rows, count, run_opt);
+}
+
+// Job: Second Chance for each row, in lockstep batches that fit the budget
+// When a full batch cannot be indexed, small frame sets are probed instead
+// and only the larger ones are charged against the budget
+static int clock_job(const Trace *trace, SimRow *rows, int count)
+{
+    size_t per_config = sizeof(int) * (size_t)(trace->universe > 0 ? trace->universe : 1);
+    int probe_small = (per_config * CLOCK_BATCH > CLOCK_BATCH_BUDGET);
+
+    for (int r = 0; r < count; )
+    {
+        int batch = 0;
+        size_t used = 0;
+
+        while (r + batch < count && batch < CLOCK_BATCH)
+        {
+            int probed = probe_small && rows[r + batch].frames <= SIMD_PROBE_MAX;
+            if (!probed && batch > 0 && used + per_config > CLOCK_BATCH_BUDGET)
+                break;
+            if (!probed)
+                used += per_config;
+            batch++;
+        }
+
+        if (run_clock_batch(trace, rows + r, batch, probe_small) != 0)
+            return -1;
+        r += batch;
+    }
+    return 0;
+}
+
+// Job: LRU for each row, read off one single-pass fault curve (or run
+// per row when the rows model the write-back pipeline)
+static int lru_job(const Trace *trace, SimRow *rows, int count)
+{
+    if (count > 0 && rows[0].flush)
+        return run_each_row(trace, rows, count, run_lru);
+
+    int max_frames = 1;
+    for (int r = 0; r < count; r++)
+    {
+        if (rows[r].frames > max_frames)
+            max_frames = rows[r].frames;
+    }
+
+    int *faults = malloc(sizeof(int) * (max_frames + 1));
+    int *write_backs = malloc(sizeof(int) * (max_frames + 1));
+    if (!faults || !write_backs || run_lru_curve(trace, max_frames, faults, write_backs) != 0)
+    {
+        free(faults);
+        free(write_backs);
+        return -1;
+    }
+
+    for (int r = 0; r < count; r++)
+    {
+        rows[r].page_faults = faults[rows[r].frames];
+        rows[r].write_backs = write_backs[rows[r].frames];
+    }
+
+    free(faults);
+    free(write_backs);
+    return 0;
+}
+
+// Job: ARC for each row
+static int arc_job(const Trace *trace, SimRow *rows, int count)
+{
+    return run_each_row(trace, rows, count, run_arc);
+}
+
+// Job: LIRS for each row
+static int lirs_job(const Trace *trace, SimRow *rows, int count)
+{
+    return run_each_row(trace, rows, count, run_lirs);
+}
+
+// Job: Enhanced Second Chance for each row
+static int esc_job(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        if (run_esc(trace, &rows[r]) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+// Job: CLOCK-Pro for each row
+static int clockpro_job(const Trace *trace, SimRow *rows, int count)
+{
+    return run_each_row(trace, rows, count, run_clockpro);
+}
+
+// Job: WS for each row
+// The working set has no frame limit, so a row with the same tau as the
+// one before it (ALL and BATCH rows differ only in frames) copies its counts
+static int ws_job(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        if (r > 0 && rows[r].tau == rows[r - 1].tau)
+        {
+            int frames = rows[r].frames;
+            rows[r] = rows[r - 1];
+            rows[r].frames = frames;
+        }
+        else if (run_ws(trace, &rows[r]) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+// Job: WSClock for each row
+static int wsclock_job(const Trace *trace, SimRow *rows, int count)
+{
+    for (int r = 0; r < count; r++)
+    {
+        if (run_wsclock(trace, &rows[r]) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+//  Output Functions 
+
+// Value of the swept parameter of a row: 'f' frames, 'n' bits, 'm' interval
+static int row_key(const SimRow *row, char key)
+{
+    if (key == 'n') return row->n;
+    if (key == 'm') return row->m;
+    return row->frames;
+}
+
+// Print a results table keyed on one swept parameter
+static void print_table(const char *title, const char *label, char key,
+                        const SimRow *rows, int count)
+{
+    printf("%s\n", title);
+    printf("+--------+--------------+--------------+\n");
+    printf("| %-6s | Page Faults  | Write-backs  |\n", label);
+    printf("+--------+--------------+--------------+\n");
+    for (int r = 0; r < count; r++)
+        printf("| %6d | %12d | %12d |\n", row_key(&rows[r], key), rows[r].page_faults, rows[r].write_backs);
+    printf("+--------+--------------+--------------+\n");
+}
+
+// Print a Second Chance grid with one row per (frames, n, m) configuration
+static void print_grid(const char *title, const SimRow *rows, int count)
+{
+    printf("%s\n", title);
+    printf("+--------+--------+--------+--------------+--------------+\n");
+    printf("| Frames | n      | m      | Page Faults  | Write-backs  |\n");
+    printf("+--------+--------+--------+--------------+--------------+\n");
+    for (int r = 0; r < count; r++)
+        printf("| %6d | %6d | %6d | %12d | %12d |\n", rows[r].frames, rows[r].n, rows[r].m,
+               rows[r].page_faults, rows[r].write_backs);
+    printf("+--------+--------+--------+--------------+--------------+\n");
+}
+
+// Pages the pipeline wrote per write-back the engine counted, or -1 when
+// the engine counted none
+static double write_amplification(const SimRow *row)
+{
+    return (row->write_backs > 0) ? (double)row->pages_written / row->write_backs : -1;
+}
+
+// Print the write-back pipeline counts of rows that modelled it
+// n and m are shown for clock rows, tau for working-set rows
+static void print_flush_table(const char *title, const SimRow *rows, int count, int clock)
+{
+    const FlushConfig *c = rows[0].flush;
+    int window = (rows[0].tau > 0);
+    const char *keys = clock ? "--------+--------+" : window ? "----------+" : "";
+
+    printf("%s write-back pipeline (queue %d, batch %d, every %d refs, cleaner %d)\n",
+           title, c->queue, c->batch, c->interval, c->cleaner);
+    printf("+--------+%s--------------+--------------+--------------+--------------+-----------+\n", keys);
+    printf("| Frames |%s Write-backs  | Pages Out    | Flush I/Os   | Queue Stalls | Write Amp |\n",
+           clock ? " n      | m      |" : window ? " Tau      |" : "");
+    printf("+--------+%s--------------+--------------+--------------+--------------+-----------+\n", keys);
+    for (int r = 0; r < count; r++)
+    {
+        const SimRow *row = &rows[r];
+        char amp[16] = "-";
+        if (write_amplification(row) >= 0)
+            snprintf(amp, sizeof(amp), "%.3f", write_amplification(row));
+
+        if (row->frames > 0)
+            printf("| %6d |", row->frames);
+        else
+            printf("| %6s |", "-");
+        if (clock)
+            printf(" %6d | %6d |", row->n, row->m);
+        else if (window)
+            printf(" %8d |", row->tau);
+        printf(" %12d | %12d | %12d | %12d | %9s |\n", row->write_backs, row->pages_written,
+               row->flush_ios, row->flush_stalls, amp);
+    }
+    printf("+--------+%s--------------+--------------+--------------+--------------+-----------+\n", keys);
+}
+
+// Print working-set results keyed on the window tau
+static void print_window_table(const char *title, const SimRow *rows, int count)
+{
+    printf("%s\n", title);
+    printf("+----------+--------------+--------------+--------------+\n");
+    printf("| Tau      | Page Faults  | Write-backs  | Avg Resident |\n");
+    printf("+----------+--------------+--------------+--------------+\n");
+    for (int r = 0; r < count; r++)
+        printf("| %8d | %12d | %12d | %12.2f |\n", rows[r].tau, rows[r].page_faults,
+               rows[r].write_backs, rows[r].avg_resident);
+    printf("+----------+--------------+--------------+--------------+\n");
+}
+
+// Output formats selected with --format
+enum { FORMAT_TABLE, FORMAT_CSV, FORMAT_JSON };
+
+// Records written so far by print_records() (JSON needs separators)
+static int records_written = 0;
+
+// 1 when records carry the write-back pipeline fields (set from the options)
+static int records_flush = 0;
+
+// 1 when records carry tau and the average resident set (WS and WSClock runs)
+static int records_window = 0;
+
+// stdout buffer: results are written in large blocks, not line by line
+static char output_buffer[1 << 16];
+
+// Write text as a JSON string literal
+static void print_json_string(const char *text)
+{
+    putchar('"');
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            printf("\\%c", *c);
+        else if (*c < 0x20)
+            printf("\\u%04x", *c);
+        else
+            putchar(*c);
+    }
+    putchar('"');
+}
+
+// Write text as a CSV field, quoted when it holds a comma, quote or newline
+static void print_csv_field(const char *text)
+{
+    if (!strpbrk(text, ",\"\n"))
+    {
+        fputs(text, stdout);
+        return;
+    }
+    putchar('"');
+    for (const char *c = text; *c; c++)
+    {
+        if (*c == '"')
+            putchar('"');
+        putchar(*c);
+    }
+    putchar('"');
+}
+
+// Start a CSV or JSON result set
+static void begin_records(int format)
+{
+    if (format == FORMAT_CSV)
+        printf("trace,algorithm,frames,n,m,page_faults,write_backs,hit_ratio,runtime_ms%s%s\n",
+               records_window ? ",tau,avg_resident" : "",
+               records_flush ? ",flush_ios,flush_stalls,pages_written,write_amplification" : "");
+    else if (format == FORMAT_JSON)
+        printf("[");
+    records_written = 0;
+}
+
+// Write one CSV line or JSON object per row
+// n and m are written only for clock rows; write_backs < 0 means unknown.
+// The hit ratio is taken over the trace's `references` references.
+// Frames are left out for WS rows (frames 0). With records_window set
+// tau and the average resident set follow the usual fields, and with
+// records_flush set the pipeline counts come last.
+static void print_records(int format, const char *trace, const char *algo, int clock,
+                          const SimRow *rows, int count, int references)
+{
+    for (int r = 0; r < count; r++)
+    {
+        const SimRow *row = &rows[r];
+        double hit_ratio = (references > 0) ? (double)(references - row->page_faults) / references : 0;
+        double runtime_ms = row->seconds * 1e3;
+
+        if (format == FORMAT_CSV)
+        {
+            print_csv_field(trace);
+            printf(",%s,", algo);
+            if (row->frames > 0)
+                printf("%d", row->frames);
+            printf(",");
+            if (clock)
+                printf("%d,%d,", row->n, row->m);
+            else
+                printf(",,");
+            printf("%d,", row->page_faults);
+            if (row->write_backs >= 0)
+                printf("%d", row->write_backs);
+            printf(",%.6f,%.3f", hit_ratio, runtime_ms);
+            if (records_window && row->tau > 0)
+                printf(",%d,%.3f", row->tau, row->avg_resident);
+            else if (records_window)
+                printf(",,");
+            if (records_flush)
+            {
+                printf(",%d,%d,%d,", row->flush_ios, row->flush_stalls, row->pages_written);
+                if (write_amplification(row) >= 0)
+                    printf("%.6f", write_amplification(row));
+            }
+            printf("\n");
+        }
+        else
+        {
+            printf("%s\n  {\"trace\": ", records_written ? "," : "");
+            print_json_string(trace);
+            printf(", \"algorithm\": \"%s\", ", algo);
+            if (row->frames > 0)
+                printf("\"frames\": %d, ", row->frames);
+            else
+                printf("\"frames\": null, ");
+            if (clock)
+                printf("\"n\": %d, \"m\": %d, ", row->n, row->m);
+            else
+                printf("\"n\": null, \"m\": null, ");
+            printf("\"page_faults\": %d, ", row->page_faults);
+            if (row->write_backs >= 0)
+                printf("\"write_backs\": %d, ", row->write_backs);
+            else
+                printf("\"write_backs\": null, ");
+            printf("\"hit_ratio\": %.6f, \"runtime_ms\": %.3f", hit_ratio, runtime_ms);
+            if (records_window && row->tau > 0)
+                printf(", \"tau\": %d, \"avg_resident\": %.3f", row->tau, row->avg_resident);
+            else if (records_window)
+                printf(", \"tau\": null, \"avg_resident\": null");
+            if (records_flush)
+            {
+                printf(", \"flush_ios\": %d, \"flush_stalls\": %d, \"pages_written\": %d, ",
+                       row->flush_ios, row->flush_stalls, row->pages_written);
+                if (write_amplification(row) >= 0)
+                    printf("\"write_amplification\": %.6f", write_amplification(row));
+                else
+                    printf("\"write_amplification\": null");
+            }
+            printf("}");
+        }
+        records_written++;
+    }
+}
+
+// Finish a CSV or JSON result set
+static void end_records(int format)
+{
+    if (format == FORMAT_JSON)
+        printf("%s]\n", records_written ? "\n" : "");
+}
+
+// Write the rows of one algorithm on the stdin trace as a whole result set
+static void print_results(int format, const char *algo, int clock,
+                          const SimRow *rows, int count, int references)
+{
+    begin_records(format);
+    print_records(format, "-", algo, clock, rows, count, references);
+    end_records(format);
+}
+
+// Split rows into job_count contiguous jobs, appended to jobs[]
+// With reverse set the last rows are queued first (when they cost most)
+// Returns the number of jobs added
+static int split_rows(SimJob *jobs, const Trace *trace, SimRow *rows, int count,
+                      int (*run)(const Trace *, SimRow *, int), int job_count, int reverse)
+{
+    if (job_count > count)
+        job_count = count;
+
+    for (int j = 0; j < job_count; j++)
+    {
+        int first = (int)((long long)count * j / job_count);
+        int slot = reverse ? job_count - 1 - j : j;
+        jobs[slot].run = run;
+        jobs[slot].trace = trace;
+        jobs[slot].rows = rows + first;
+        jobs[slot].count = (int)((long long)count * (j + 1) / job_count) - first;
+    }
+    return job_count;
+}
+
+// Number of Second Chance jobs: full lockstep batches, but at least one
+// job per thread when there are enough configurations
+static int clock_jobs(int count, int threads)
+{
+    int jobs = (count + CLOCK_BATCH - 1) / CLOCK_BATCH;
+    if (jobs < threads)
+        jobs = (count < threads) ? count : threads;
+    return jobs;
+}
+
+// Algorithms that can be run together on a trace (ALL, BATCH)
+enum { ALGO_FIFO, ALGO_OPT, ALGO_LRU, ALGO_CLK, ALGO_ARC, ALGO_LIRS, ALGO_CLOCKPRO, ALGO_ESC,
+       ALGO_WS, ALGO_WSCLOCK, ALGO_COUNT };
+static const char *const algo_names[ALGO_COUNT] = { "FIFO", "OPT", "LRU", "CLK", "ARC", "LIRS", "CLOCK-Pro", "ESC",
+                                                    "WS", "WSClock" };
+
+// Job that simulates a set of rows of each algorithm
+static int (*const fast_engines[ALGO_COUNT])(const Trace *, SimRow *, int) =
+    { run_fifo_sweep, opt_job, lru_job, clock_job, arc_job, lirs_job, clockpro_job, esc_job,
+      ws_job, wsclock_job };
+
+// The same, with the reference loops (--reference, VERIFY)
+static int (*const reference_engines[ALGO_COUNT])(const Trace *, SimRow *, int) =
+    { reference_fifo, reference_opt, reference_lru, reference_clock, reference_arc,
+      reference_lirs, reference_clockpro, reference_esc, reference_ws, reference_wsclock };
+
+// 1 for algorithms whose rows carry a register width n and shift interval m
+static int register_algo(int algo)
+{
+    return algo == ALGO_CLK || algo == ALGO_ESC;
+}
+
+// 1 for algorithms whose rows carry a working-set window tau
+static int window_algo(int algo)
+{
+    return algo == ALGO_WS || algo == ALGO_WSCLOCK;
+}
+
+// Queue one algorithm's rows on a trace, split the way its own mode splits
+// them; jobs[] needs room for max(count, threads) entries
+// Returns the number of jobs added
+static int algo_jobs(SimJob *jobs, int algo, const Trace *trace,
+                     SimRow *rows, int count, int threads, int reference)
+{
+    int (*run)(const Trace *, SimRow *, int) = reference ? reference_engines[algo] : fast_engines[algo];
+    int flush = (count > 0 && rows[0].flush);  // The pipeline runs FIFO and LRU per row
+
+    if (algo == ALGO_FIFO)
+        return split_rows(jobs, trace, rows, count, run, flush ? count : threads, 0);
+    if (algo == ALGO_LRU)  // One pass serves every row unless run per row
+        return split_rows(jobs, trace, rows, count, run, (reference || flush) ? count : 1, 0);
+    if (algo == ALGO_CLK)
+        return split_rows(jobs, trace, rows, count, run, clock_jobs(count, threads), 0);
+    if (algo == ALGO_WS && !reference && count > 0 && rows[0].tau == rows[count - 1].tau)
+        return split_rows(jobs, trace, rows, count, run, 1, 0);  // Rows differ only in frames
+    // The rest run one configuration per job
+    return split_rows(jobs, trace, rows, count, run, count, algo == ALGO_OPT);
+}
+
+// Run one algorithm's rows on the pool, split as algo_jobs() splits them
+// Returns 0 on success, -1 on failure
+static int run_algo(const Trace *trace, int algo, int reference,
+                    SimRow *rows, int count, int threads)
+{
+    SimJob *jobs = malloc(sizeof(SimJob) * (count > threads ? count : threads));
+    if (!jobs) return -1;
+
+    int job_count = algo_jobs(jobs, algo, trace, rows, count, threads, reference);
+    int result = run_jobs(jobs, job_count, threads);
+    free(jobs);
+    return result;
+}
+
+//  Option Parsing 
+
+// Inclusive parameter range lo, lo + step, ..., up to hi
+typedef struct
+{
+    int lo;
+    int hi;
+    int step;
+} Range;
+
+// Command-line options following the algorithm name
+typedef struct
+{
+    int threads;     // Worker threads (-j)
+    int frames_set;  // 1 if --frames (or a frame ceiling) was given
+    Range frames;    // Frame counts to simulate
+    Range n;         // Register widths swept with m fixed (CLK, GRID)
+    Range m;         // Shift intervals swept with n fixed (CLK, GRID)
+    int fixed_n;     // n used while sweeping m (CLK), and by ESC
+    int fixed_m;     // m used while sweeping n (CLK), and by ESC
+    double wb_budget;  // Fraction of ESC evictions that may pick a dirty page
+    Range tau;       // Working-set windows swept (WS, WSClock)
+    int fixed_tau;   // Window used by WS and WSClock alongside other algorithms
+    int algos;       // Bit (1 << ALGO_*) per algorithm to run (BATCH)
+    char **files;    // Trace files (BATCH)
+    int file_count;
+    int format;      // FORMAT_* for results
+    int warmup;      // Untimed runs before the trials (BENCH)
+    int trials;      // Timed runs per configuration (BENCH)
+    int reference;   // 1 to run the reference loops instead of the fast engines
+    int flush_set;   // 1 if any write-back pipeline option was given
+    FlushConfig flush;  // Write-back pipeline modelled behind every engine
+} Options;
+
+// Number of values in a range
+static int range_count(const Range *r)
+{
+    return (r->hi - r->lo) / r->step + 1;
+}
+
+// k-th value of a range
+static int range_value(const Range *r, int k)
+{
+    return r->lo + k * r->step;
+}
+
+// Parse "LO", "LO:HI" or "LO:HI:STEP" with 1 <= LO <= HI <= max
+// Returns 0 on success, -1 on malformed input
+static int parse_range(const char *text, int max, Range *r)
+{
+    char *end;
+    long lo = strtol(text, &end, 10);
+    long hi = lo;
+    long step = 1;
+
+    if (end != text && *end == ':')
+    {
+        const char *rest = end + 1;
+        hi = strtol(rest, &end, 10);
+        if (end == rest)
+            return -1;
+        if (*end == ':')
+        {
+            rest = end + 1;
+            step = strtol(rest, &end, 10);
+            if (end == rest)
+                return -1;
+        }
+    }
+    if (end == text || *end != '\0' || lo < 1 || hi < lo || hi > max || step < 1)
+        return -1;
+
+    r->lo = (int)lo;
+    r->hi = (int)hi;
+    r->step = (int)step;
+    return 0;
+}
+
+// Parse a positive integer no larger than max
+// Returns 0 on success, -1 on malformed input
+static int parse_count(const char *text, int max, int *value)
+{
+    char *end;
+    long v = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || v < 1 || v > max)
+        return -1;
+    *value = (int)v;
+    return 0;
+}
+
+// Parse a fraction in [0, 1]
+// Returns 0 on success, -1 on malformed input
+static int parse_fraction(const char *text, double *value)
+{
+    char *end;
+    double v = strtod(text, &end);
+    if (end == text || *end != '\0' || !(v >= 0 && v <= 1))
+        return -1;
+    *value = v;
+    return 0;
+}
+
+// Parse the GEN options and output path into spec
+// Returns the output path, or NULL after reporting a bad option
+static const char *parse_gen_options(int argc, char *argv[], GenSpec *spec)
+{
+    const char *path = NULL;
+    int set_given = 0;
+
+    spec->length = 1000000;
+    spec->universe = 10000;
+    spec->dist = DIST_UNIFORM;
+    spec->skew = 0.99;
+    spec->set_size = 0;
+    spec->phase_length = 100000;
+    spec->hot = 0.9;
+    spec->dirty = 0.3;
+    spec->seed = 1;
+    spec->binary = 0;
+
+    for (int a = 2; a < argc; a++)
+    {
+        const char *arg = argv[a];
+        char *end = NULL;
+        int bad = 0;
+
+        if (strncmp(arg, "--length=", 9) == 0)
+        {
+            spec->length = strtoll(arg + 9, &end, 10);
+            bad = (end == arg + 9 || *end != '\0' || spec->length < 0);
+        }
+        else if (strncmp(arg, "--universe=", 11) == 0)
+            bad = parse_count(arg + 11, INT_MAX, &spec->universe);
+        else if (strncmp(arg, "--dist=", 7) == 0)
+        {
+            spec->dist = 0;
+            while (spec->dist < DIST_COUNT && strcmp(arg + 7, dist_names[spec->dist]) != 0)
+                spec->dist++;
+            bad = (spec->dist == DIST_COUNT);
+        }
+        else if (strncmp(arg, "--skew=", 7) == 0)
+        {
+            spec->skew = strtod(arg + 7, &end);
+            bad = (end == arg + 7 || *end != '\0' || !(spec->skew > 0 && spec->skew <= 100));
+        }
+        else if (strncmp(arg, "--set=", 6) == 0)
+        {
+            bad = parse_count(arg + 6, INT_MAX, &spec->set_size);
+            set_given = 1;
+        }
+        else if (strncmp(arg, "--phase=", 8) == 0)
+        {
+            spec->phase_length = strtoll(arg + 8, &end, 10);
+            bad = (end == arg + 8 || *end != '\0' || spec->phase_length < 1);
+        }
+        else if (strncmp(arg, "--hot=", 6) == 0)
+            bad = parse_fraction(arg + 6, &spec->hot);
+        else if (strncmp(arg, "--dirty=", 8) == 0)
+            bad = parse_fraction(arg + 8, &spec->dirty);
+        else if (strncmp(arg, "--seed=", 7) == 0)
+        {
+            spec->seed = strtoull(arg + 7, &end, 10);
+            bad = (end == arg + 7 || *end != '\0');
+        }
+        else if (strcmp(arg, "--binary") == 0)
+            spec->binary = 1;
+        else if ((arg[0] != '-' || strcmp(arg, "-") == 0) && !path)
+            path = arg;
+        else
+            bad = 1;
+
+        if (bad)
+        {
+            fprintf(stderr, "Invalid option: %s\n", arg);
+            return NULL;
+        }
+    }
+
+    // Working and hot sets default to a tenth of the universe
+    if (!set_given)
+        spec->set_size = (spec->universe >= 10) ? spec->universe / 10 : 1;
+    if (spec->set_size > spec->universe)
+    {
+        fprintf(stderr, "Invalid option: --set exceeds --universe\n");
+        return NULL;
+    }
+    if (!path)
+        fprintf(stderr, "Missing output file\n");
+    return path;
+}
+
+// Index of the algorithm named by the first len characters of text
+// Returns ALGO_* or -1 if there is no such algorithm
+static int algo_index(const char *text, size_t len)
+{
+    for (int algo = 0; algo < ALGO_COUNT; algo++)
+    {
+        if (strlen(algo_names[algo]) == len && strncmp(text, algo_names[algo], len) == 0)
+            return algo;
+    }
+    return -1;
+}
+
+// Parse a comma-separated list of algorithm names into a bit mask
+// Returns 0 on success, -1 on an unknown or missing name
+static int parse_algos(const char *text, int *mask)
+{
+    *mask = 0;
+    while (1)
+    {
+        size_t len = strcspn(text, ",");
+        int algo = algo_index(text, len);
+        if (algo < 0)
+            return -1;
+
+        *mask |= 1 << algo;
+        if (text[len] == '\0')
+            return 0;
+        text += len + 1;
+    }
+}
+
+// Parse the options after the algorithm name into opt
+// In BATCH mode bare arguments are trace files rather than a frame ceiling
+// Returns 0 on success, -1 after reporting a bad option
+static int parse_options(int argc, char *argv[], Options *opt)
+{
+    int batch = (strcmp(argv[1], "BATCH") == 0 || strcmp(argv[1], "VERIFY") == 0);
+
+    opt->threads = 1;
+    opt->frames_set = 0;
+    opt->frames = (Range){ 1, 100, 1 };
+    opt->n = (Range){ 1, 32, 1 };
+    opt->m = (Range){ 1, 100, 1 };
+    opt->fixed_n = 8;
+    opt->fixed_m = 10;
+    opt->wb_budget = 0;
+    opt->tau = (Range){ 100, 10000, 100 };
+    opt->fixed_tau = 1000;
+    opt->algos = (1 << ALGO_COUNT) - 1;
+    opt->files = malloc(sizeof(char *) * argc);
+    opt->file_count = 0;
+    opt->format = FORMAT_TABLE;
+    opt->warmup = 1;
+    opt->trials = 5;
+    opt->reference = 0;
+    opt->flush_set = 0;
+    opt->flush = (FlushConfig){ 64, 16, 100, 0 };
+    if (!opt->files)
+        return -1;
+
+    for (int a = 2; a < argc; a++)
+    {
+        const char *arg = argv[a];
+        int bad = 0;
+
+        if (strncmp(arg, "-j", 2) == 0)
+        {
+            const char *value = arg[2] ? arg + 2 : (a + 1 < argc ? argv[++a] : "");
+            bad = parse_count(value, 4096, &opt->threads);
+        }
+        else if (strncmp(arg, "--frames=", 9) == 0)
+        {
+            bad = parse_range(arg + 9, INT_MAX / 2, &opt->frames);
+            opt->frames_set = 1;
+        }
+        else if (strncmp(arg, "--n=", 4) == 0)
+            bad = parse_range(arg + 4, 32, &opt->n);
+        else if (strncmp(arg, "--m=", 4) == 0)
+            bad = parse_range(arg + 4, INT_MAX, &opt->m);
+        else if (strncmp(arg, "--fixed-n=", 10) == 0)
+            bad = parse_count(arg + 10, 32, &opt->fixed_n);
+        else if (strncmp(arg, "--fixed-m=", 10) == 0)
+            bad = parse_count(arg + 10, INT_MAX, &opt->fixed_m);
+        else if (strncmp(arg, "--wb-budget=", 12) == 0)
+            bad = parse_fraction(arg + 12, &opt->wb_budget);
+        else if (strncmp(arg, "--tau=", 6) == 0)
+            bad = parse_range(arg + 6, INT_MAX / 2, &opt->tau);
+        else if (strncmp(arg, "--fixed-tau=", 12) == 0)
+            bad = parse_count(arg + 12, INT_MAX / 2, &opt->fixed_tau);
+        else if (strcmp(arg, "--warmup=0") == 0)
+            opt->warmup = 0;
+        else if (strncmp(arg, "--warmup=", 9) == 0)
+            bad = parse_count(arg + 9, 1000, &opt->warmup);
+        else if (strncmp(arg, "--trials=", 9) == 0)
+            bad = parse_count(arg + 9, 100000, &opt->trials);
+        else if (strcmp(arg, "--reference") == 0)
+            opt->reference = 1;
+        else if (strncmp(arg, "--flush-queue=", 14) == 0)
+        {
+            bad = parse_count(arg + 14, INT_MAX, &opt->flush.queue);
+            opt->flush_set = 1;
+        }
+        else if (strncmp(arg, "--flush-batch=", 14) == 0)
+        {
+            bad = parse_count(arg + 14, INT_MAX, &opt->flush.batch);
+            opt->flush_set = 1;
+        }
+        else if (strncmp(arg, "--flush-interval=", 17) == 0)
+        {
+            bad = parse_count(arg + 17, INT_MAX, &opt->flush.interval);
+            opt->flush_set = 1;
+        }
+        else if (strncmp(arg, "--cleaner=", 10) == 0)
+        {
+            opt->flush.cleaner = 0;
+            if (strcmp(arg + 10, "0") != 0)
+                bad = parse_count(arg + 10, INT_MAX, &opt->flush.cleaner);
+            opt->flush_set = 1;
+        }
+        else if (strcmp(arg, "--format=table") == 0)
+            opt->format = FORMAT_TABLE;
+        else if (strcmp(arg, "--format=csv") == 0)
+            opt->format = FORMAT_CSV;
+        else if (strcmp(arg, "--format=json") == 0)
+            opt->format = FORMAT_JSON;
+        else if (strncmp(arg, "--algos=", 8) == 0)
+            bad = parse_algos(arg + 8, &opt->algos);
+        else if (batch && arg[0] != '-')
+            opt->files[opt->file_count++] = argv[a];
+        else if (arg[0] != '-')
+        {
+            // Bare number: frame ceiling, i.e. --frames=1:N
+            bad = parse_count(arg, INT_MAX / 2, &opt->frames.hi);
+            opt->frames.lo = 1;
+            opt->frames.step = 1;
+            opt->frames_set = 1;
+        }
+        else
+            bad = -1;
+
+        if (bad)
+        {
+            fprintf(stderr, "Invalid option: %s\n", arg);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Print usage
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s FIFO|OPT|CLK|ESC|GRID|CURVE|LRU|ARC|LIRS|CLOCK-Pro|WS|WSClock [options] < inputfile.csv\n", prog);
+    fprintf(stderr, "       %s ALL|ALGO,ALGO,... [options] < inputfile.csv\n", prog);
+    fprintf(stderr, "       %s BATCH [options] trace...\n", prog);
+    fprintf(stderr, "       %s BENCH [options] < inputfile.csv\n", prog);
+    fprintf(stderr, "       %s VERIFY [options] [trace...]\n", prog);
+    fprintf(stderr, "       %s CONVERT output.bin < inputfile.csv\n", prog);
+    fprintf(stderr, "       %s GEN [generator options] output|-\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -j N                 run on N threads\n");
+    fprintf(stderr, "  --frames=LO[:HI[:S]] frame counts (default 1:100, CLK/GRID/WSClock 50)\n");
+    fprintf(stderr, "  N                    same as --frames=1:N\n");
+    fprintf(stderr, "  --n=LO[:HI[:S]]      CLK/GRID register widths (default 1:32)\n");
+    fprintf(stderr, "  --m=LO[:HI[:S]]      CLK/GRID shift intervals (default 1:100)\n");
+    fprintf(stderr, "  --fixed-n=N          CLK register width while sweeping m, ALL/ESC n (default 8)\n");
+    fprintf(stderr, "  --fixed-m=M          CLK shift interval while sweeping n, ALL/ESC m (default 10)\n");
+    fprintf(stderr, "  --wb-budget=F        fraction of ESC evictions that may take a dirty page\n");
+    fprintf(stderr, "                       before a clean one is found (default 0)\n");
+    fprintf(stderr, "  --tau=LO[:HI[:S]]    WS/WSClock windows in references (default 100:10000:100)\n");
+    fprintf(stderr, "  --fixed-tau=T        WS/WSClock window alongside other algorithms (default 1000)\n");
+    fprintf(stderr, "  --format=FMT         table (default), csv or json\n");
+    fprintf(stderr, "  --reference          run the straightforward reference loops\n");
+    fprintf(stderr, "  --algos=A,B,...      ALL/BATCH/BENCH/VERIFY algorithms (default all)\n");
+    fprintf(stderr, "  --flush-queue=Q      model an asynchronous write-back queue of Q pages\n");
+    fprintf(stderr, "                       behind every engine (default 64 once any flush\n");
+    fprintf(stderr, "                       option is given; not with --reference, CURVE, BENCH)\n");
+    fprintf(stderr, "  --flush-batch=B      pages written per batched flush I/O (default 16)\n");
+    fprintf(stderr, "  --flush-interval=D   references between flusher wake-ups (default 100)\n");
+    fprintf(stderr, "  --cleaner=N          dirty resident pages queued per wake-up (default 0)\n");
+    fprintf(stderr, "  --warmup=N           BENCH untimed runs per configuration (default 1)\n");
+    fprintf(stderr, "  --trials=N           BENCH timed runs per configuration (default 5)\n");
+    fprintf(stderr, "Generator options:\n");
+    fprintf(stderr, "  --length=N           references to write (default 1000000)\n");
+    fprintf(stderr, "  --universe=U         distinct pages 0..U-1 (default 10000)\n");
+    fprintf(stderr, "  --dist=D             uniform, zipf, seq, loop or phase (default uniform)\n");
+    fprintf(stderr, "  --skew=S             zipf exponent (default 0.99)\n");
+    fprintf(stderr, "  --set=W              loop working set / phase hot set (default U/10)\n");
+    fprintf(stderr, "  --phase=P            references before the hot set moves (default 100000)\n");
+    fprintf(stderr, "  --hot=F              fraction of references to the hot set (default 0.9)\n");
+    fprintf(stderr, "  --dirty=F            fraction of dirty references (default 0.3)\n");
+    fprintf(stderr, "  --seed=N             generator seed (default 1)\n");
+    fprintf(stderr, "  --binary             write the binary format instead of CSV\n");
+}
+
+// Allocate one row per value of the frame range
+static SimRow *frame_rows(const Range *frames)
+{
+    int count = range_count(frames);
+    SimRow *rows = malloc(sizeof(SimRow) * count);
+    if (!rows) return NULL;
+
+    for (int k = 0; k < count; k++)
+    {
+        rows[k] = (SimRow){ 0 };
+        rows[k].frames = range_value(frames, k);
+    }
+    return rows;
+}
+
+// Allocate one row per frame count for an algorithm, with the write-back
+// pipeline if one was asked for; CLK and ESC use the fixed n and m, WS and
+// WSClock the fixed tau
+static SimRow *algo_rows(const Options *opt, int algo)
+{
+    SimRow *rows = frame_rows(&opt->frames);
+    if (!rows) return NULL;
+
+    for (int k = 0; k < range_count(&opt->frames); k++)
+    {
+        rows[k].flush = opt->flush_set ? &opt->flush : NULL;
+        if (window_algo(algo))
+            rows[k].tau = opt->fixed_tau;
+        if (!register_algo(algo))
+            continue;
+        rows[k].n = opt->fixed_n;
+        rows[k].m = opt->fixed_m;
+        rows[k].wb_budget = opt->wb_budget;
+    }
+    return rows;
+}
+
+// Allocate the rows of both CLK experiments for every frame count:
+// n swept with m fixed, then m swept with n fixed
+// Sets *count to the number of rows
+static SimRow *clock_rows(const Options *opt, const Range *frames, int *count)
+{
+    int n_count = range_count(&opt->n);
+    int m_count = range_count(&opt->m);
+    int per_frame = n_count + m_count;
+    long long total = (long long)range_count(frames) * per_frame;
+    if (total > INT_MAX / (int)sizeof(SimRow))
+        return NULL;
+
+    *count = (int)total;
+    SimRow *rows = malloc(sizeof(SimRow) * *count);
+    if (!rows) return NULL;
+
+    for (int k = 0; k < *count; k++)
+    {
+        int e = k % per_frame;
+        rows[k] = (SimRow){ 0 };
+        rows[k].frames = range_value(frames, k / per_frame);
+        rows[k].n = (e < n_count) ? range_value(&opt->n, e) : opt->fixed_n;      // n = number of bits in reference register
+        rows[k].m = (e < n_count) ? opt->fixed_m : range_value(&opt->m, e - n_count);  // m = shift interval
+        rows[k].flush = opt->flush_set ? &opt->flush : NULL;
+    }
+    return rows;
+}
+
+// Allocate one row per (frame count, tau) for WSClock, or with frames NULL
+// one row per tau for WS, whose working set has no frame limit
+static SimRow *window_rows(const Options *opt, const Range *frames, int *count)
+{
+    int tau_count = range_count(&opt->tau);
+    long long total = (long long)(frames ? range_count(frames) : 1) * tau_count;
+    if (total > INT_MAX / (int)sizeof(SimRow))
+        return NULL;
+
+    *count = (int)total;
+    SimRow *rows = malloc(sizeof(SimRow) * *count);
+    if (!rows) return NULL;
+
+    for (int k = 0; k < *count; k++)
+    {
+        rows[k] = (SimRow){ 0 };
+        rows[k].frames = frames ? range_value(frames, k / tau_count) : 0;
+        rows[k].tau = range_value(&opt->tau, k % tau_count);
+        rows[k].flush = opt->flush_set ? &opt->flush : NULL;
+    }
+    return rows;
+}
+
+// Results of one algorithm on one trace (BATCH)
+typedef struct
+{
+    int trace;     // Index into the trace file list
+    int algo;
+    SimRow *rows;
+    int count;
+} BatchResult;
+
+// Print every batch result in one table, one line per configuration
+static void print_batch(char **files, const BatchResult *results, int result_count)
+{
+    int width = 5;
+    for (int r = 0; r < result_count; r++)
+    {
+        int len = (int)strlen(files[results[r].trace]);
+        if (len > width)
+            width = len;
+    }
+
+    char rule[96];
+    int dashes = (width + 2 < (int)sizeof(rule)) ? width + 2 : (int)sizeof(rule) - 1;
+    memset(rule, '-', dashes);
+    rule[dashes] = '\0';
+
+    printf("Batch\n");
+    printf("+%s+-----------+--------+--------+--------+--------------+--------------+\n", rule);
+    printf("| %-*s | Algorithm | Frames | n      | m      | Page Faults  | Write-backs  |\n", width, "Trace");
+    printf("+%s+-----------+--------+--------+--------+--------------+--------------+\n", rule);
+    for (int r = 0; r < result_count; r++)
+    {
+        const BatchResult *res = &results[r];
+        for (int k = 0; k < res->count; k++)
+        {
+            const SimRow *row = &res->rows[k];
+            printf("| %-*s | %-9s | %6d | ", width, files[res->trace], algo_names[res->algo], row->frames);
+            if (register_algo(res->algo))
+                printf("%6d | %6d | ", row->n, row->m);
+            else
+                printf("%6s | %6s | ", "-", "-");
+            printf("%12d | %12d |\n", row->page_faults, row->write_backs);
+        }
+    }
+    printf("+%s+-----------+--------+--------+--------+--------------+--------------+\n", rule);
+}
+
+// Print one row per frame count with every algorithm's faults and
+// write-backs side by side; results[a] holds the rows of algorithm algos[a]
+static void print_comparison(const char *title, const int *algos, SimRow *const *results,
+                             int algo_count, int frame_count)
+{
+    printf("%s\n", title);
+    printf("+--------+");
+    for (int a = 0; a < algo_count; a++)
+        printf("---------------------------+");
+    printf("\n|        |");
+    for (int a = 0; a < algo_count; a++)
+        printf(" %-25s |", algo_names[algos[a]]);
+    printf("\n| Frames |");
+    for (int a = 0; a < algo_count; a++)
+        printf(" %12s %12s |", "Page Faults", "Write-backs");
+    printf("\n+--------+");
+    for (int a = 0; a < algo_count; a++)
+        printf("---------------------------+");
+    printf("\n");
+
+    for (int k = 0; k < frame_count; k++)
+    {
+        printf("| %6d |", results[0][k].frames);
+        for (int a = 0; a < algo_count; a++)
+            printf(" %12d %12d |", results[a][k].page_faults, results[a][k].write_backs);
+        printf("\n");
+    }
+
+    printf("+--------+");
+    for (int a = 0; a < algo_count; a++)
+        printf("---------------------------+");
+    printf("\n");
+}
+
+// Print plain Second Chance next to Enhanced Second Chance at each frame
+// count, with the change in faults and write-backs and totals over all rows
+static void print_esc_tradeoff(const Options *opt, const SimRow *clk, const SimRow *esc, int count)
+{
+    long long totals[4] = { 0 };
+
+    printf("ESC vs CLK (n=%d, m=%d, write-back budget %.2f)\n", opt->fixed_n, opt->fixed_m, opt->wb_budget);
+    printf("+--------+---------------------------+---------------------------+---------------------------+\n");
+    printf("|        | CLK                       | ESC                       | ESC - CLK                 |\n");
+    printf("| Frames |  Page Faults  Write-backs |  Page Faults  Write-backs |  Page Faults  Write-backs |\n");
+    printf("+--------+---------------------------+---------------------------+---------------------------+\n");
+    for (int k = 0; k < count; k++)
+    {
+        printf("| %6d | %12d %12d | %12d %12d | %+12d %+12d |\n", clk[k].frames,
+               clk[k].page_faults, clk[k].write_backs, esc[k].page_faults, esc[k].write_backs,
+               esc[k].page_faults - clk[k].page_faults, esc[k].write_backs - clk[k].write_backs);
+        totals[0] += clk[k].page_faults;
+        totals[1] += clk[k].write_backs;
+        totals[2] += esc[k].page_faults;
+        totals[3] += esc[k].write_backs;
+    }
+    printf("+--------+---------------------------+---------------------------+---------------------------+\n");
+    printf("| Total  | %12lld %12lld | %12lld %12lld | %+12lld %+12lld |\n", totals[0], totals[1],
+           totals[2], totals[3], totals[2] - totals[0], totals[3] - totals[1]);
+    printf("+--------+---------------------------+---------------------------+---------------------------+\n");
+}
+
+// ALL (or a list like FIFO,OPT,CLK): run every selected algorithm on one
+// loaded trace, all of them on one pool, and print them side by side
+// CLK and ESC use the fixed n and m for every frame count, WS and WSClock
+// the fixed tau
+// Returns 0 on success, -1 on allocation failure
+static int run_comparison(const Trace *trace, const Options *opt, int mask)
+{
+    int algos[ALGO_COUNT];
+    SimRow *results[ALGO_COUNT];
+    int algo_count = 0;
+    int frame_count = range_count(&opt->frames);
+    int status = 0;
+
+    for (int a = 0; a < ALGO_COUNT; a++)
+    {
+        if (!((mask >> a) & 1))
+            continue;
+
+        SimRow *rows = algo_rows(opt, a);
+        if (!rows)
+        {
+            status = -1;
+            break;
+        }
+        algos[algo_count] = a;
+        results[algo_count++] = rows;
+    }
+
+    int per_algo = (frame_count > opt->threads) ? frame_count : opt->threads;
+    SimJob *jobs = (status == 0) ? malloc(sizeof(SimJob) * per_algo * algo_count) : NULL;
+    if (jobs)
+    {
+        int job_count = 0;
+        for (int a = 0; a < algo_count; a++)
+            job_count += algo_jobs(jobs + job_count, algos[a], trace, results[a], frame_count,
+                                   opt->threads, opt->reference);
+        status = run_jobs(jobs, job_count, opt->threads);
+    }
+    else
+        status = -1;
+
+    if (status == 0 && opt->format != FORMAT_TABLE)
+    {
+        records_window = (mask & ((1 << ALGO_WS) | (1 << ALGO_WSCLOCK))) != 0;
+        begin_records(opt->format);
+        for (int a = 0; a < algo_count; a++)
+            print_records(opt->format, "-", algo_names[algos[a]], register_algo(algos[a]),
+                          results[a], frame_count, trace->count);
+        end_records(opt->format);
+    }
+    else if (status == 0)
+    {
+        char title[96] = "Comparison";
+        int clock = mask & ((1 << ALGO_CLK) | (1 << ALGO_ESC));
+        int window = mask & ((1 << ALGO_WS) | (1 << ALGO_WSCLOCK));
+        if (clock && window)
+            snprintf(title, sizeof(title), "Comparison (CLK/ESC n=%d, m=%d; WS/WSClock tau=%d)",
+                     opt->fixed_n, opt->fixed_m, opt->fixed_tau);
+        else if (clock)
+            snprintf(title, sizeof(title), "Comparison (CLK/ESC n=%d, m=%d)", opt->fixed_n, opt->fixed_m);
+        else if (window)
+            snprintf(title, sizeof(title), "Comparison (WS/WSClock tau=%d)", opt->fixed_tau);
+        print_comparison(title, algos, results, algo_count, frame_count);
+        for (int a = 0; opt->flush_set && a < algo_count; a++)
+        {
+            printf("\n");
+            print_flush_table(algo_names[algos[a]], results[a], frame_count, register_algo(algos[a]));
+        }
+    }
+
+    free(jobs);
+    for (int a = 0; a < algo_count; a++)
+        free(results[a]);
+    return status;
+}
+
+// Run time statistics of one benchmarked configuration
+typedef struct
+{
+    int algo;
+    int frames;
+    double ns_min;      // Nanoseconds per reference over the trials
+    double ns_median;
+    double ns_p90;
+    double ns_max;
+    long peak_rss_kb;   // Peak resident set size of the process running it
+} BenchStat;
+
+// Order doubles ascending (qsort)
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted[0..count)
+static double percentile(const double *sorted, int count, int pct)
+{
+    int rank = (pct * count + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Time one configuration in a child process: warm-up runs, then `trials`
+// timed runs whose seconds are sent back through a pipe. A separate
+// process gives each configuration its own peak RSS (from wait4()).
+// Returns 0 on success, -1 if the child could not run
+static int bench_config(const Trace *trace, int (*run)(const Trace *, SimRow *, int),
+                        SimRow config, int warmup, int trials, double *seconds, long *peak_rss_kb)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+        return -1;
+
+    fflush(stdout);
+    pid_t child = fork();
+    if (child < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    if (child == 0)
+    {
+        close(fds[0]);
+        for (int t = 0; t < warmup + trials; t++)
+        {
+            SimRow row = config;
+            double start = now_seconds();
+            if (run(trace, &row, 1) != 0)
+                _exit(1);
+            double elapsed = now_seconds() - start;
+            if (t >= warmup && write(fds[1], &elapsed, sizeof(elapsed)) != sizeof(elapsed))
+                _exit(1);
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+    size_t want = sizeof(double) * trials;
+    size_t got = 0;
+    while (got < want)
+    {
+        ssize_t n = read(fds[0], (char *)seconds + got, want - got);
+        if (n <= 0)
+            break;
+        got += (size_t)n;
+    }
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+    if (wait4(child, &status, 0, &usage) != child || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0 || got != want)
+        return -1;
+
+    *peak_rss_kb = usage.ru_maxrss;
+    return 0;
+}
+
+// Print benchmark statistics as a table, CSV or JSON
+static void print_bench(const Options *opt, const BenchStat *stats, int count, int references)
+{
+    if (opt->format == FORMAT_CSV)
+        printf("algorithm,frames,n,m,trials,refs_per_sec,ns_per_ref_min,ns_per_ref_median,"
+               "ns_per_ref_p90,ns_per_ref_max,peak_rss_kb\n");
+    else if (opt->format == FORMAT_JSON)
+        printf("[");
+    else
+    {
+        printf("Bench (%d references, %d warm-up, %d trials, CLK/ESC n=%d, m=%d, WS/WSClock tau=%d)\n",
+               references, opt->warmup, opt->trials, opt->fixed_n, opt->fixed_m, opt->fixed_tau);
+        printf("+-----------+--------+--------------+----------+----------+----------+----------+-------------+\n");
+        printf("| Algorithm | Frames | Refs/sec     | ns/ref   | ns/ref   | ns/ref   | ns/ref   | Peak RSS    |\n");
+        printf("|           |        | (median)     | min      | median   | p90      | max      | KB          |\n");
+        printf("+-----------+--------+--------------+----------+----------+----------+----------+-------------+\n");
+    }
+
+    for (int k = 0; k < count; k++)
+    {
+        const BenchStat *st = &stats[k];
+        double rate = (st->ns_median > 0) ? 1e9 / st->ns_median : 0;
+        int clock = register_algo(st->algo);
+
+        if (opt->format == FORMAT_CSV)
+        {
+            printf("%s,%d,", algo_names[st->algo], st->frames);
+            if (clock)
+                printf("%d,%d,", opt->fixed_n, opt->fixed_m);
+            else
+                printf(",,");
+            printf("%d,%.0f,%.3f,%.3f,%.3f,%.3f,%ld\n", opt->trials, rate, st->ns_min,
+                   st->ns_median, st->ns_p90, st->ns_max, st->peak_rss_kb);
+        }
+        else if (opt->format == FORMAT_JSON)
+        {
+            printf("%s\n  {\"algorithm\": \"%s\", \"frames\": %d, ", k ? "," : "",
+                   algo_names[st->algo], st->frames);
+            if (clock)
+                printf("\"n\": %d, \"m\": %d, ", opt->fixed_n, opt->fixed_m);
+            else
+                printf("\"n\": null, \"m\": null, ");
+            printf("\"trials\": %d, \"refs_per_sec\": %.0f, \"ns_per_ref_min\": %.3f, "
+                   "\"ns_per_ref_median\": %.3f, \"ns_per_ref_p90\": %.3f, \"ns_per_ref_max\": %.3f, "
+                   "\"peak_rss_kb\": %ld}", opt->trials, rate, st->ns_min, st->ns_median,
+                   st->ns_p90, st->ns_max, st->peak_rss_kb);
+        }
+        else
+            printf("| %-9s | %6d | %12.0f | %8.2f | %8.2f | %8.2f | %8.2f | %11ld |\n",
+                   algo_names[st->algo], st->frames, rate, st->ns_min, st->ns_median,
+                   st->ns_p90, st->ns_max, st->peak_rss_kb);
+    }
+
+    if (opt->format == FORMAT_JSON)
+        printf("%s]\n", count ? "\n" : "");
+    else if (opt->format == FORMAT_TABLE)
+        printf("+-----------+--------+--------------+----------+----------+----------+----------+-------------+\n");
+}
+
+// BENCH: time every selected algorithm at every frame count on its own,
+// one configuration at a time so trials do not compete for the CPU
+// CLK and ESC use the fixed n and m. Returns 0 on success, -1 on failure
+static int run_bench(const Trace *trace, const Options *opt, int mask)
+{
+    int frame_count = range_count(&opt->frames);
+    int algo_count = 0;
+    for (int a = 0; a < ALGO_COUNT; a++)
+        algo_count += (mask >> a) & 1;
+
+    BenchStat *stats = malloc(sizeof(BenchStat) * frame_count * algo_count);
+    double *seconds = malloc(sizeof(double) * opt->trials);
+    if (!stats || !seconds)
+    {
+        free(stats);
+        free(seconds);
+        return -1;
+    }
+
+    int count = 0;
+    for (int a = 0; a < ALGO_COUNT; a++)
+    {
+        if (!((mask >> a) & 1))
+            continue;
+
+        for (int k = 0; k < frame_count; k++)
+        {
+            SimRow config = { 0 };
+            config.frames = range_value(&opt->frames, k);
+            config.n = opt->fixed_n;
+            config.m = opt->fixed_m;
+            config.wb_budget = opt->wb_budget;
+            config.tau = opt->fixed_tau;
+            BenchStat *st = &stats[count++];
+
+            int (*run)(const Trace *, SimRow *, int) = opt->reference ? reference_engines[a] : fast_engines[a];
+            if (bench_config(trace, run, config, opt->warmup, opt->trials, seconds, &st->peak_rss_kb) != 0)
+            {
+                free(stats);
+                free(seconds);
+                return -1;
+            }
+
+            // Per-reference cost of each trial
+            double refs = (trace->count > 0) ? trace->count : 1;
+            for (int t = 0; t < opt->trials; t++)
+                seconds[t] = seconds[t] * 1e9 / refs;
+            qsort(seconds, opt->trials, sizeof(double), compare_doubles);
+
+            st->algo = a;
+            st->frames = config.frames;
+            st->ns_min = seconds[0];
+            st->ns_median = (opt->trials % 2) ? seconds[opt->trials / 2]
+                : (seconds[opt->trials / 2 - 1] + seconds[opt->trials / 2]) / 2;
+            st->ns_p90 = percentile(seconds, opt->trials, 90);
+            st->ns_max = seconds[opt->trials - 1];
+        }
+    }
+
+    print_bench(opt, stats, count, trace->count);
+    free(stats);
+    free(seconds);
+    return 0;
+}
+
+// Free a trace and everything derived from it
+static void free_trace(Trace *trace)
+{
+    free(trace->pages);
+    free(trace->page_numbers);
+    free(trace->next_use);
+    free(trace->ids.keys);
+    free(trace->ids.vals);
+}
+
+// BATCH: load every trace file once, then run every (trace, algorithm,
+// configuration) job on one pool and print one consolidated table
+// Returns 0 on success, 1 after reporting a failure
+static int run_batch(const Options *opt)
+{
+    int algo_count = 0;
+    for (int a = 0; a < ALGO_COUNT; a++)
+        algo_count += (opt->algos >> a) & 1;
+
+    // Second Chance experiments default to 50 frames
+    Range clock_frames = opt->frames_set ? opt->frames : (Range){ 50, 50, 1 };
+
+    int result_count = opt->file_count * algo_count;
+    Trace *traces = calloc(opt->file_count > 0 ? opt->file_count : 1, sizeof(Trace));
+    BatchResult *results = calloc(result_count > 0 ? result_count : 1, sizeof(BatchResult));
+    if (!traces || !results)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    int status = 0;
+    long long job_total = 0;
+    for (int t = 0, r = 0; t < opt->file_count && status == 0; t++)
+    {
+        FILE *in = fopen(opt->files[t], "rb");
+        if (!in || load_trace(&traces[t], fileno(in)) != 0)
+        {
+            fprintf(stderr, "Failed to read %s\n", opt->files[t]);
+            status = 1;
+        }
+        else if ((opt->algos & (1 << ALGO_OPT)) && build_next_use(&traces[t]) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            status = 1;
+        }
+        if (in)
+            fclose(in);
+
+        for (int a = 0; a < ALGO_COUNT && status == 0; a++)
+        {
+            if (!((opt->algos >> a) & 1))
+                continue;
+
+            BatchResult *res = &results[r++];
+            res->trace = t;
+            res->algo = a;
+            if (a == ALGO_CLK)
+                res->rows = clock_rows(opt, &clock_frames, &res->count);
+            else
+            {
+                res->rows = algo_rows(opt, a);
+                res->count = range_count(&opt->frames);
+            }
+            if (!res->rows)
+            {
+                fprintf(stderr, "Out of memory\n");
+                status = 1;
+            }
+            job_total += (res->count > opt->threads) ? res->count : opt->threads;
+        }
+    }
+
+    SimJob *jobs = NULL;
+    if (status == 0)
+    {
+        if (job_total <= INT_MAX / (int)sizeof(SimJob))
+            jobs = malloc(sizeof(SimJob) * (job_total > 0 ? job_total : 1));
+
+        // Every job of every trace goes on one pool
+        int job_count = 0;
+        for (int r = 0; jobs && r < result_count; r++)
+            job_count += algo_jobs(jobs + job_count, results[r].algo, &traces[results[r].trace],
+                                   results[r].rows, results[r].count, opt->threads, opt->reference);
+        if (!jobs || run_jobs(jobs, job_count, opt->threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            status = 1;
+        }
+        else if (opt->format == FORMAT_TABLE)
+        {
+            print_batch(opt->files, results, result_count);
+            for (int r = 0; opt->flush_set && r < result_count; r++)
+            {
+                char title[256];
+                snprintf(title, sizeof(title), "%s %s", opt->files[results[r].trace], algo_names[results[r].algo]);
+                printf("\n");
+                print_flush_table(title, results[r].rows, results[r].count, register_algo(results[r].algo));
+            }
+        }
+        else
+        {
+            records_window = (opt->algos & ((1 << ALGO_WS) | (1 << ALGO_WSCLOCK))) != 0;
+            begin_records(opt->format);
+            for (int r = 0; r < result_count; r++)
+                print_records(opt->format, opt->files[results[r].trace], algo_names[results[r].algo],
+                              register_algo(results[r].algo), results[r].rows, results[r].count,
+                              traces[results[r].trace].count);
+            end_records(opt->format);
+        }
+    }
+
+    free(jobs);
+    for (int r = 0; r < result_count; r++)
+        free(results[r].rows);
+    for (int t = 0; t < opt->file_count; t++)
+        free_trace(&traces[t]);
+    free(results);
+    free(traces);
+    return status;
+}
+
+// Compare every selected fast engine with its reference loop on one trace
+// and print one line per algorithm, naming the first mismatching
+// configuration if there is one
+// Returns the number of algorithms that mismatched, or -1 on failure
+static int verify_trace(Trace *trace, const char *name, const Options *opt, const Range *clock_frames)
+{
+    SimRow *fast[ALGO_COUNT] = { NULL };
+    SimRow *slow[ALGO_COUNT] = { NULL };
+    int counts[ALGO_COUNT] = { 0 };
+    int job_total = 0;
+    int status = 0;
+
+    if ((opt->algos & (1 << ALGO_OPT)) && build_next_use(trace) != 0)
+        return -1;
+
+    for (int a = 0; a < ALGO_COUNT && status == 0; a++)
+    {
+        if (!((opt->algos >> a) & 1))
+            continue;
+
+        if (a == ALGO_CLK)
+        {
+            fast[a] = clock_rows(opt, clock_frames, &counts[a]);
+            slow[a] = clock_rows(opt, clock_frames, &counts[a]);
+        }
+        else
+        {
+            fast[a] = algo_rows(opt, a);
+            slow[a] = algo_rows(opt, a);
+            counts[a] = range_count(&opt->frames);
+        }
+        if (!fast[a] || !slow[a])
+            status = -1;
+        job_total += 2 * ((counts[a] > opt->threads) ? counts[a] : opt->threads);
+    }
+
+    // Fast and reference jobs share one pool
+    SimJob *jobs = (status == 0) ? malloc(sizeof(SimJob) * (job_total > 0 ? job_total : 1)) : NULL;
+    if (jobs)
+    {
+        int job_count = 0;
+        for (int a = 0; a < ALGO_COUNT; a++)
+        {
+            if (!fast[a])
+                continue;
+            job_count += algo_jobs(jobs + job_count, a, trace, slow[a], counts[a], opt->threads, 1);
+            job_count += algo_jobs(jobs + job_count, a, trace, fast[a], counts[a], opt->threads, 0);
+        }
+        status = run_jobs(jobs, job_count, opt->threads);
+    }
+    else
+        status = -1;
+
+    for (int a = 0; a < ALGO_COUNT && status >= 0; a++)
+    {
+        if (!fast[a])
+            continue;
 
-    // OPTIMAL ALGORITHM
-    else if (strcmp(argv[1], "OPT") == 0)
+        int k = 0;
+        while (k < counts[a] && fast[a][k].page_faults == slow[a][k].page_faults &&
+               fast[a][k].write_backs == slow[a][k].write_backs &&
+               fast[a][k].avg_resident == slow[a][k].avg_resident)
+            k++;
+
+        printf("%-24s %-9s ", name, algo_names[a]);
+        if (k == counts[a])
+        {
+            printf("%d configurations match\n", counts[a]);
+            continue;
+        }
+
+        printf("MISMATCH at frames=%d", fast[a][k].frames);
+        if (register_algo(a))
+            printf(", n=%d, m=%d", fast[a][k].n, fast[a][k].m);
+        if (window_algo(a))
+            printf(", tau=%d", fast[a][k].tau);
+        printf(": faults %d (reference %d), write-backs %d (reference %d)",
+               fast[a][k].page_faults, slow[a][k].page_faults,
+               fast[a][k].write_backs, slow[a][k].write_backs);
+        if (window_algo(a))
+            printf(", resident %.3f (reference %.3f)", fast[a][k].avg_resident, slow[a][k].avg_resident);
+        printf("\n");
+        status++;
+    }
+
+    free(jobs);
+    for (int a = 0; a < ALGO_COUNT; a++)
     {
-        printf("OPT\n");
-        printf("+--------+--------------+--------------+\n");
-        printf("| Frames | Page Faults  | Write-backs  |\n");
-        printf("+--------+--------------+--------------+\n");
-
-        // Run simulation for 1 to 100 frames
-        for (int f = 1; f <= 100; f++)
-        {
-            // Use simple arrays for frame management
-            int frame_pages[100];
-            int frame_dirty[100];
-            int frame_order[100];  // For FIFO tie-breaking
-            int used = 0;
-            int timestamp = 0;  // Tracks insertion order for tie-breaking
-            
-            // Initialize frames to -1
-            for (int x = 0; x < f; x++) {
-                frame_pages[x] = -1;
-                frame_dirty[x] = 0;
-                frame_order[x] = 0;
-            }
-            
-            int page_faults = 0;
-            int write_backs = 0;
-
-            // Process each page reference
-            for (int i = 0; i < page_count; i++)
-            {
-                int pg = pages[i].page;
-                int d = pages[i].dirty;
-                int hit = -1;
-
-                // Check if page is in frames
-                for (int x = 0; x < used; x++)
-                {
-                    if (frame_pages[x] == pg)
-                    {
-                        hit = x;
-                        break;
-                    }
-                }
+        free(fast[a]);
+        free(slow[a]);
+    }
+    return status;
+}
 
-                if (hit != -1)
-                {
-                    // Page hit - update dirty bit if needed
-                    if (d == 1)
-                    {
-                        frame_dirty[hit] = 1;
-                    }
-                }
-                else
-                {
-                    // Page fault
-                    page_faults++;
+// VERIFY: check the fast engines against the reference loops on a set of
+// generated traces (every distribution, small and larger universes) and on
+// every trace file given
+// Returns 0 if everything matches, 1 on a mismatch or failure
+static int run_verify(const Options *opt)
+{
+    // Second Chance experiments default to 50 frames
+    Range clock_frames = opt->frames_set ? opt->frames : (Range){ 50, 50, 1 };
+    static const int universes[] = { 64, 400 };
+    int mismatches = 0;
 
-                    if (used < f)
-                    {
-                        // Frames not full - just add
-                        frame_pages[used] = pg;
-                        frame_dirty[used] = d;
-                        frame_order[used] = timestamp++;
-                        used++;
-                    }
-                    else
-                    {
-                        // Frames full - find victim using optimal algorithm
-                        int victim = 0;
-                        int farthest = -1;
-                        int oldest_order = INT_MAX;
+    int generated = DIST_COUNT * (int)(sizeof(universes) / sizeof(universes[0]));
+    for (int t = 0; t < generated + opt->file_count; t++)
+    {
+        Trace trace = { 0 };
+        char name[64];
+        int loaded;
 
-                        // Find page with farthest next use
-                        for (int x = 0; x < f; x++)
-                        {
-                            int next = find_next_use(i, frame_pages[x]);
-
-                            // Choose page with farthest next use
-                            if (next > farthest)
-                            {
-                                farthest = next;
-                                victim = x;
-                                oldest_order = frame_order[x];
-                            }
-                            // Tie-breaking: use FIFO order (oldest first)
-                            else if (next == farthest)
-                            {
-                                if (frame_order[x] < oldest_order)
-                                {
-                                    victim = x;
-                                    oldest_order = frame_order[x];
-                                }
-                            }
-                        }
+        if (t < generated)
+        {
+            // Generate into a temporary binary file and read it back
+            GenSpec spec = { 5000, universes[t / DIST_COUNT], t % DIST_COUNT, 0.99, 0, 500,
+                             0.9, 0.3, (unsigned long long)t + 1, 1 };
+            spec.set_size = spec.universe / 10;
+            snprintf(name, sizeof(name), "gen:%s/U%d", dist_names[spec.dist], spec.universe);
 
-                        // Evict victim and write back if dirty
-                        if (frame_dirty[victim] == 1)
-                        {
-                            write_backs++;
-                        }
+            FILE *tmp = tmpfile();
+            loaded = tmp && generate_trace(&spec, tmp) == 0 && fflush(tmp) == 0 &&
+                     fseek(tmp, 0, SEEK_SET) == 0 && load_trace(&trace, fileno(tmp)) == 0;
+            if (tmp)
+                fclose(tmp);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "%s", opt->files[t - generated]);
+            FILE *in = fopen(opt->files[t - generated], "rb");
+            loaded = in && load_trace(&trace, fileno(in)) == 0;
+            if (in)
+                fclose(in);
+        }
 
-                        // Replace victim with new page
-                        frame_pages[victim] = pg;
-                        frame_dirty[victim] = d;
-                        frame_order[victim] = timestamp++;
-                    }
-                }
-            }
+        int result = loaded ? verify_trace(&trace, name, opt, &clock_frames) : -1;
+        free_trace(&trace);
+        if (result < 0)
+        {
+            fprintf(stderr, "Failed to verify %s\n", name);
+            return 1;
+        }
+        mismatches += result;
+        fflush(stdout);
+    }
+
+    if (mismatches)
+        printf("%d mismatching engine runs\n", mismatches);
+    else
+        printf("All engines match the reference implementations\n");
+    return mismatches ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // Check if the user provided the correct number of arguments
+    if (argc < 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Trace trace = { 0 };
+
+    // CSV -> BINARY CONVERSION
+    if (strcmp(argv[1], "CONVERT") == 0)
+    {
+        if (argc != 3)
+        {
+            fprintf(stderr, "Usage: %s CONVERT output.bin < inputfile.csv\n", argv[0]);
+            return 1;
+        }
+        if (load_trace(&trace, STDIN_FILENO) != 0)
+        {
+            fprintf(stderr, "Failed to read input trace\n");
+            return 1;
+        }
+
+        FILE *out = fopen(argv[2], "wb");
+        if (!out)
+        {
+            fprintf(stderr, "Cannot open %s\n", argv[2]);
+            return 1;
+        }
+        int failed = save_binary_trace(&trace, out);
+        if (fclose(out) != 0 || failed)
+        {
+            fprintf(stderr, "Failed to write %s\n", argv[2]);
+            return 1;
+        }
+        return 0;
+    }
+
+    // SYNTHETIC TRACE GENERATION
+    if (strcmp(argv[1], "GEN") == 0)
+    {
+        GenSpec spec;
+        const char *path = parse_gen_options(argc, argv, &spec);
+        if (!path)
+        {
+            usage(argv[0]);
+            return 1;
+        }
 
-            printf("| %6d | %12d | %12d |\n", f, page_faults, write_backs);
+        FILE *out = (strcmp(path, "-") == 0) ? stdout : fopen(path, "wb");
+        if (!out)
+        {
+            fprintf(stderr, "Cannot open %s\n", path);
+            return 1;
+        }
+        int failed = generate_trace(&spec, out);
+        if (fclose(out) != 0 || failed)
+        {
+            fprintf(stderr, "Failed to write %s\n", path);
+            return 1;
         }
-        printf("+--------+--------------+--------------+\n");
+        return 0;
     }
 
-    // SECOND CHANCE (CLOCK) ALGORITHM 
-    else if (strcmp(argv[1], "CLK") == 0)
+    init_probe();
+    setvbuf(stdout, output_buffer, _IOFBF, sizeof(output_buffer));
+
+    // Parse options following the algorithm name
+    Options opt;
+    if (parse_options(argc, argv, &opt) != 0)
     {
-        int frames = 50;  // Fixed at 50 frames for Second Chance
+        usage(argv[0]);
+        return 1;
+    }
 
-        //  Experiment 1: m=10, vary n from 1 to 32
-        printf("CLK, m=10\n");
-        printf("+--------+--------------+--------------+\n");
-        printf("| n      | Page Faults  | Write-backs  |\n");
-        printf("+--------+--------------+--------------+\n");
+    // The write-back pipeline follows the fast engines' evictions
+    if (opt.flush_set && (opt.reference || strcmp(argv[1], "CURVE") == 0 || strcmp(argv[1], "BENCH") == 0))
+    {
+        fprintf(stderr, "The write-back pipeline does not run with --reference, CURVE or BENCH\n");
+        return 1;
+    }
+    records_flush = opt.flush_set;
 
-        int m = 10;  // Shift reference bits every 10 references
-        for (int n = 1; n <= 32; n++)  // n = number of bits in reference register
+    // Many trace files, each loaded once
+    if (strcmp(argv[1], "BATCH") == 0)
+    {
+        if (opt.file_count == 0)
         {
-            ClockFrameList *cfl = create_clock_frameList(frames);
-            int page_faults = 0;
-            int write_backs = 0;
-            int ref_counter = 0;  // Counter for shifting reference bits
+            usage(argv[0]);
+            return 1;
+        }
+        int status = run_batch(&opt);
+        free(opt.files);
+        return status;
+    }
 
-            // Process each page reference
-            for (int i = 0; i < page_count; i++)
-            {
-                int current_page = pages[i].page;
-                int current_dirty = pages[i].dirty;
-                int page_index = -1;
+    // Fast engines against the reference loops
+    if (strcmp(argv[1], "VERIFY") == 0)
+    {
+        int status = run_verify(&opt);
+        free(opt.files);
+        return status;
+    }
 
-                // Check if page is already in memory
-                if (contains_clock_frame(cfl, current_page, &page_index))
-                {
-                    // Page hit - set reference bit and update dirty flag
-                    set_reference_bit(cfl, page_index, n);
-                    if (current_dirty == 1)
-                        cfl->frame[page_index].dirty = 1;
-                }
-                else
-                {
-                    // Page fault
-                    page_faults++;
+    // Second Chance experiments default to 50 frames
+    int clock_mode = (strcmp(argv[1], "CLK") == 0 || strcmp(argv[1], "GRID") == 0 ||
+                      strcmp(argv[1], "WSClock") == 0);
+    if (clock_mode && !opt.frames_set)
+        opt.frames = (Range){ 50, 50, 1 };
 
-                    if (cfl->size < cfl->capacity)
-                    {
-                        // Frames not full - just add the page
-                        int idx = cfl->size;
-                        cfl->frame[idx].page = current_page;
-                        cfl->frame[idx].dirty = current_dirty;
-                        cfl->frame[idx].ref_bits = 0;
-                        set_reference_bit(cfl, idx, n);
-                        cfl->size++;
-                    }
-                    else
-                    {
-                        // Frames full - find a victim page
-                        int victim_idx = find_victim_clock(cfl, n);
-                        
-                        // Write back if victim page is dirty
-                        if (cfl->frame[victim_idx].dirty == 1)
-                            write_backs++;
-
-                        // Replace victim with new page
-                        cfl->frame[victim_idx].page = current_page;
-                        cfl->frame[victim_idx].dirty = current_dirty;
-                        cfl->frame[victim_idx].ref_bits = 0;
-                        set_reference_bit(cfl, victim_idx, n);
-                    }
-                }
+    // Read input from stdin (CSV or binary)
+    if (load_trace(&trace, STDIN_FILENO) != 0)
+    {
+        fprintf(stderr, "Failed to read input trace\n");
+        return 1;
+    }
 
-                // Shift reference bits after m references
-                ref_counter++;
-                if (ref_counter >= m)
-                {
-                    shift_reference_bits(cfl, n);
-                    ref_counter = 0;
-                }
+    int frame_count = range_count(&opt.frames);
+    int algo = algo_index(argv[1], strlen(argv[1]));
+
+    //  FIFO ALGORITHM 
+    if (strcmp(argv[1], "FIFO") == 0)
+    {
+        // Run simulation for every frame count, one sweep per worker
+        SimRow *rows = algo_rows(&opt, ALGO_FIFO);
+        if (!rows || run_algo(&trace, ALGO_FIFO, opt.reference, rows, frame_count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        if (opt.format == FORMAT_TABLE)
+        {
+            print_table("FIFO", "Frames", 'f', rows, frame_count);
+            if (opt.flush_set)
+            {
+                printf("\n");
+                print_flush_table("FIFO", rows, frame_count, 0);
+            }
+        }
+        else
+            print_results(opt.format, "FIFO", 0, rows, frame_count, trace.count);
+        free(rows);
+    }
+
+    // OPTIMAL ALGORITHM
+    else if (strcmp(argv[1], "OPT") == 0)
+    {
+        // Precompute next uses once so victim selection never rescans the trace
+        // Run one job per frame count, largest frame counts first
+        SimRow *rows = algo_rows(&opt, ALGO_OPT);
+        if (!rows || build_next_use(&trace) != 0 ||
+            run_algo(&trace, ALGO_OPT, opt.reference, rows, frame_count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        if (opt.format == FORMAT_TABLE)
+        {
+            print_table("OPT", "Frames", 'f', rows, frame_count);
+            if (opt.flush_set)
+            {
+                printf("\n");
+                print_flush_table("OPT", rows, frame_count, 0);
             }
+        }
+        else
+            print_results(opt.format, "OPT", 0, rows, frame_count, trace.count);
+        free(rows);
+    }
 
-            printf("| %6d | %12d | %12d |\n", n, page_faults, write_backs);
-            free_clock_frameList(cfl);
+    // LRU ALGORITHM (single pass over the trace)
+    else if (strcmp(argv[1], "LRU") == 0)
+    {
+        SimRow *rows = algo_rows(&opt, ALGO_LRU);
+        if (!rows || run_algo(&trace, ALGO_LRU, opt.reference, rows, frame_count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        if (opt.format == FORMAT_TABLE)
+        {
+            print_table("LRU", "Frames", 'f', rows, frame_count);
+            if (opt.flush_set)
+            {
+                printf("\n");
+                print_flush_table("LRU", rows, frame_count, 0);
+            }
         }
-        printf("+--------+--------------+--------------+\n\n");
+        else
+            print_results(opt.format, "LRU", 0, rows, frame_count, trace.count);
+        free(rows);
+    }
 
-        // Experiment 2: n=8, vary m from 1 to 100 
-        printf("CLK, n=8\n");
-        printf("+--------+--------------+--------------+\n");
-        printf("| m      | Page Faults  | Write-backs  |\n");
-        printf("+--------+--------------+--------------+\n");
+    // ARC, LIRS and CLOCK-Pro ALGORITHMS (one job per frame count)
+    else if (algo == ALGO_ARC || algo == ALGO_LIRS || algo == ALGO_CLOCKPRO)
+    {
+        SimRow *rows = algo_rows(&opt, algo);
+        if (!rows || run_algo(&trace, algo, opt.reference, rows, frame_count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        if (opt.format == FORMAT_TABLE)
+        {
+            print_table(algo_names[algo], "Frames", 'f', rows, frame_count);
+            if (opt.flush_set)
+            {
+                printf("\n");
+                print_flush_table(algo_names[algo], rows, frame_count, 0);
+            }
+        }
+        else
+            print_results(opt.format, algo_names[algo], 0, rows, frame_count, trace.count);
+        free(rows);
+    }
 
-        int n = 8;  // Fixed at 8 bits
-        for (int m = 1; m <= 100; m++)  // m = shift interval
+    // ENHANCED SECOND CHANCE against plain CLK, same n and m at every frame count
+    else if (algo == ALGO_ESC)
+    {
+        SimRow *clk = algo_rows(&opt, ALGO_CLK);
+        SimRow *esc = algo_rows(&opt, ALGO_ESC);
+        SimJob *jobs = malloc(sizeof(SimJob) * 2 * (frame_count > opt.threads ? frame_count : opt.threads));
+        int job_count = 0;
+        if (clk && esc && jobs)
         {
-            ClockFrameList *cfl = create_clock_frameList(frames);
-            int page_faults = 0;
-            int write_backs = 0;
-            int ref_counter = 0;
+            job_count += algo_jobs(jobs, ALGO_CLK, &trace, clk, frame_count, opt.threads, opt.reference);
+            job_count += algo_jobs(jobs + job_count, ALGO_ESC, &trace, esc, frame_count, opt.threads, opt.reference);
+        }
+        if (!clk || !esc || !jobs || run_jobs(jobs, job_count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
 
-            // Process each page reference
-            for (int i = 0; i < page_count; i++)
+        if (opt.format == FORMAT_TABLE)
+        {
+            print_esc_tradeoff(&opt, clk, esc, frame_count);
+            for (int a = 0; opt.flush_set && a < 2; a++)
             {
-                int current_page = pages[i].page;
-                int current_dirty = pages[i].dirty;
-                int page_index = -1;
+                printf("\n");
+                print_flush_table(a ? "ESC" : "CLK", a ? esc : clk, frame_count, 1);
+            }
+        }
+        else
+        {
+            begin_records(opt.format);
+            print_records(opt.format, "-", "CLK", 1, clk, frame_count, trace.count);
+            print_records(opt.format, "-", "ESC", 1, esc, frame_count, trace.count);
+            end_records(opt.format);
+        }
+        free(jobs);
+        free(clk);
+        free(esc);
+    }
 
-                // Check if page is already in memory
-                if (contains_clock_frame(cfl, current_page, &page_index))
-                {
-                    // Page hit - set reference bit and update dirty flag
-                    set_reference_bit(cfl, page_index, n);
-                    if (current_dirty == 1)
-                        cfl->frame[page_index].dirty = 1;
-                }
-                else
-                {
-                    // Page fault
-                    page_faults++;
+    // WORKING SET, one row per window tau
+    else if (algo == ALGO_WS)
+    {
+        int count = 0;
+        SimRow *rows = window_rows(&opt, NULL, &count);
+        if (!rows || run_algo(&trace, ALGO_WS, opt.reference, rows, count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        records_window = 1;
+        if (opt.format == FORMAT_TABLE)
+        {
+            print_window_table("WS", rows, count);
+            if (opt.flush_set)
+            {
+                printf("\n");
+                print_flush_table("WS", rows, count, 0);
+            }
+        }
+        else
+            print_results(opt.format, "WS", 0, rows, count, trace.count);
+        free(rows);
+    }
 
-                    if (cfl->size < cfl->capacity)
-                    {
-                        // Frames not full - just add the page
-                        int idx = cfl->size;
-                        cfl->frame[idx].page = current_page;
-                        cfl->frame[idx].dirty = current_dirty;
-                        cfl->frame[idx].ref_bits = 0;
-                        set_reference_bit(cfl, idx, n);
-                        cfl->size++;
-                    }
-                    else
-                    {
-                        // Frames full - find a victim page
-                        int victim_idx = find_victim_clock(cfl, n);
-                        
-                        // Write back if victim page is dirty
-                        if (cfl->frame[victim_idx].dirty == 1)
-                            write_backs++;
-
-                        // Replace victim with new page
-                        cfl->frame[victim_idx].page = current_page;
-                        cfl->frame[victim_idx].dirty = current_dirty;
-                        cfl->frame[victim_idx].ref_bits = 0;
-                        set_reference_bit(cfl, victim_idx, n);
-                    }
-                }
+    // WSCLOCK, for each frame count one row per window tau
+    else if (algo == ALGO_WSCLOCK)
+    {
+        int tau_count = range_count(&opt.tau);
+        int count = 0;
+        SimRow *rows = window_rows(&opt, &opt.frames, &count);
+        if (!rows || run_algo(&trace, ALGO_WSCLOCK, opt.reference, rows, count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        records_window = 1;
+        if (opt.format != FORMAT_TABLE)
+            print_results(opt.format, "WSClock", 0, rows, count, trace.count);
+        for (int fr = 0; opt.format == FORMAT_TABLE && fr < frame_count; fr++)
+        {
+            char title[64];
+            snprintf(title, sizeof(title), "WSClock, frames=%d", rows[fr * tau_count].frames);
+            if (fr > 0)
+                printf("\n");
+            print_window_table(title, rows + fr * tau_count, tau_count);
+        }
+        if (opt.format == FORMAT_TABLE && opt.flush_set)
+        {
+            printf("\n");
+            print_flush_table("WSClock", rows, count, 0);
+        }
+        free(rows);
+    }
 
-                // Shift reference bits after m references
-                ref_counter++;
-                if (ref_counter >= m)
-                {
-                    shift_reference_bits(cfl, n);
-                    ref_counter = 0;
-                }
+    // OPT FAULT CURVE (single pass over the trace)
+    else if (strcmp(argv[1], "CURVE") == 0)
+    {
+        int max_frames = opt.frames.hi;
+        int *faults = malloc(sizeof(int) * (max_frames + 1));
+        SimRow *rows = frame_rows(&opt.frames);
+        double start = now_seconds();
+        if (!faults || !rows || build_next_use(&trace) != 0 ||
+            run_opt_curve(&trace, max_frames, faults) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+
+        // Write-backs are not known from the curve
+        double share = (now_seconds() - start) / frame_count;
+        for (int k = 0; k < frame_count; k++)
+        {
+            rows[k].page_faults = faults[rows[k].frames];
+            rows[k].write_backs = -1;
+            rows[k].seconds = share;
+        }
+        if (opt.format != FORMAT_TABLE)
+            print_results(opt.format, "OPT", 0, rows, frame_count, trace.count);
+        else
+        {
+            printf("OPT curve\n");
+            printf("+--------+--------------+\n");
+            printf("| Frames | Page Faults  |\n");
+            printf("+--------+--------------+\n");
+            for (int k = 0; k < frame_count; k++)
+                printf("| %6d | %12d |\n", rows[k].frames, rows[k].page_faults);
+            printf("+--------+--------------+\n");
+            printf("Page faults are exact (one-pass OPT stack distances).\n");
+            printf("Write-backs depend on tie-breaks between unused pages and are not\n");
+            printf("computed here; run OPT for exact write-back counts.\n");
+        }
+
+        free(faults);
+        free(rows);
+    }
+
+    // SECOND CHANCE (CLOCK) ALGORITHM 
+    else if (strcmp(argv[1], "CLK") == 0)
+    {
+        // For each frame count:
+        //  Experiment 1: m fixed (default 10), vary n (default 1 to 32)
+        //  Experiment 2: n fixed (default 8), vary m (default 1 to 100)
+        int n_count = range_count(&opt.n);
+        int m_count = range_count(&opt.m);
+        int per_frame = n_count + m_count;
+        int count = 0;
+        SimRow *rows = clock_rows(&opt, &opt.frames, &count);
+        if (!rows)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+
+        if (run_algo(&trace, ALGO_CLK, opt.reference, rows, count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+
+        if (opt.format != FORMAT_TABLE)
+            print_results(opt.format, "CLK", 1, rows, count, trace.count);
+        for (int fr = 0; opt.format == FORMAT_TABLE && fr < frame_count; fr++)
+        {
+            SimRow *block = rows + fr * per_frame;
+            char title[64];
+
+            if (fr > 0)
+                printf("\n");
+            if (opt.frames_set)
+                snprintf(title, sizeof(title), "CLK, frames=%d, m=%d", block[0].frames, opt.fixed_m);
+            else
+                snprintf(title, sizeof(title), "CLK, m=%d", opt.fixed_m);
+            print_table(title, "n", 'n', block, n_count);
+            printf("\n");
+
+            if (opt.frames_set)
+                snprintf(title, sizeof(title), "CLK, frames=%d, n=%d", block[0].frames, opt.fixed_n);
+            else
+                snprintf(title, sizeof(title), "CLK, n=%d", opt.fixed_n);
+            print_table(title, "m", 'm', block + n_count, m_count);
+        }
+        if (opt.format == FORMAT_TABLE && opt.flush_set)
+        {
+            printf("\n");
+            print_flush_table("CLK", rows, count, 1);
+        }
+        free(rows);
+    }
+
+    // SECOND CHANCE PARAMETER GRID (frames x n x m)
+    else if (strcmp(argv[1], "GRID") == 0)
+    {
+        int n_count = range_count(&opt.n);
+        int m_count = range_count(&opt.m);
+        long long total = (long long)frame_count * n_count * m_count;
+        if (total > INT_MAX / (int)sizeof(SimRow))
+        {
+            fprintf(stderr, "Grid too large\n");
+            return 1;
+        }
+
+        int count = (int)total;
+        SimRow *rows = malloc(sizeof(SimRow) * count);
+        if (!rows)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+
+        for (int k = 0; k < count; k++)
+        {
+            rows[k] = (SimRow){ 0 };
+            rows[k].frames = range_value(&opt.frames, k / (n_count * m_count));
+            rows[k].n = range_value(&opt.n, (k / m_count) % n_count);
+            rows[k].m = range_value(&opt.m, k % m_count);
+            rows[k].flush = opt.flush_set ? &opt.flush : NULL;
+        }
+
+        if (run_algo(&trace, ALGO_CLK, opt.reference, rows, count, opt.threads) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        if (opt.format == FORMAT_TABLE)
+        {
+            print_grid("CLK grid", rows, count);
+            if (opt.flush_set)
+            {
+                printf("\n");
+                print_flush_table("CLK grid", rows, count, 1);
             }
+        }
+        else
+            print_results(opt.format, "CLK", 1, rows, count, trace.count);
+        free(rows);
+    }
+
+    // SEVERAL ALGORITHMS SIDE BY SIDE (ALL or a list such as FIFO,OPT,CLK)
+    else if (strcmp(argv[1], "ALL") == 0 || strchr(argv[1], ','))
+    {
+        int mask = opt.algos;
+        if (strcmp(argv[1], "ALL") != 0 && parse_algos(argv[1], &mask) != 0)
+        {
+            fprintf(stderr, "Unknown algorithm: %s\n", argv[1]);
+            return 1;
+        }
+        if (((mask & (1 << ALGO_OPT)) && build_next_use(&trace) != 0) ||
+            run_comparison(&trace, &opt, mask) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+    }
 
-            printf("| %6d | %12d | %12d |\n", m, page_faults, write_backs);
-            free_clock_frameList(cfl);
+    // BENCHMARK (one configuration at a time)
+    else if (strcmp(argv[1], "BENCH") == 0)
+    {
+        if (((opt.algos & (1 << ALGO_OPT)) && build_next_use(&trace) != 0) ||
+            run_bench(&trace, &opt, opt.algos) != 0)
+        {
+            fprintf(stderr, "Benchmark failed\n");
+            return 1;
         }
-        printf("+--------+--------------+--------------+\n");
     }
 
     // Invalid algorithm specified
@@ -644,6 +6916,8 @@ int main(int argc, char *argv[])
         fprintf(stderr, "Unknown algorithm: %s\n", argv[1]);
         return 1;
     }
-    
+
+    free_trace(&trace);
+    free(opt.files);
     return 0;
-}
\ No newline at end of file
+}